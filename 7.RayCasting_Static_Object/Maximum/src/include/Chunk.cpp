@@ -0,0 +1,316 @@
+#include "Chunk.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    void unlink(ChunkStream &stream, int slot)
+    {
+        ChunkSlot &node = stream.slots[slot];
+
+        if (node.prev >= 0) stream.slots[node.prev].next = node.next;
+        else stream.lruHead = node.next;
+
+        if (node.next >= 0) stream.slots[node.next].prev = node.prev;
+        else stream.lruTail = node.prev;
+
+        node.prev = -1;
+        node.next = -1;
+    }
+
+    void pushFront(ChunkStream &stream, int slot)
+    {
+        ChunkSlot &node = stream.slots[slot];
+        node.prev = -1;
+        node.next = stream.lruHead;
+
+        if (stream.lruHead >= 0) stream.slots[stream.lruHead].prev = slot;
+        stream.lruHead = slot;
+        if (stream.lruTail < 0) stream.lruTail = slot;
+    }
+
+    void loadChunk(const ChunkStream &stream, int chunk, ChunkRuns &runs)
+    {
+        runs.runStart.assign(CHUNK_SIZE, 0);
+        runs.rowRun.assign(CHUNK_SIZE, 0);
+        runs.runTile.clear();
+
+        int left = (chunk % stream.chunksX) * CHUNK_SIZE;
+        int top = (chunk / stream.chunksX) * CHUNK_SIZE;
+        int width = std::min(CHUNK_SIZE, stream.width - left);
+        int height = std::min(CHUNK_SIZE, stream.height - top);
+
+        // One strided read per row, only the page of this chunk is touched
+        for (int i = 0; i < CHUNK_SIZE; ++i)
+        {
+            const unsigned char *row = (i < height) ? stream.tileData + (static_cast<std::size_t>(top + i) * stream.width + left) * stream.tileBytes : nullptr;
+            runs.rowRun[i] = static_cast<unsigned short>(runs.runTile.size());
+
+            for (int j = 0; j < CHUNK_SIZE; ++j)
+            {
+                // Tile outside the map (edge chunk) stay empty
+                int tile = 0;
+                if (i < height && j < width)
+                {
+                    tile = (stream.tileBytes == 2) ? reinterpret_cast<const unsigned short *>(row)[j] : row[j];
+                    if (tile >= stream.tileTypes) tile = 0;
+                }
+
+                if (j > 0 && tile == runs.runTile.back()) continue;
+
+                runs.runStart[i] |= 1ull << j;
+                runs.runTile.push_back(static_cast<unsigned short>(tile));
+            }
+        }
+
+        // One run per row all with same tile: uniform chunk, drop the table
+        if (runs.runTile.size() == CHUNK_SIZE && std::all_of(runs.runTile.begin(), runs.runTile.end(), [&runs](unsigned short tile) { return tile == runs.runTile[0]; }))
+        {
+            runs.runStart = {};
+            runs.rowRun = {};
+            runs.runTile.resize(1);
+        }
+
+        runs.runTile.shrink_to_fit();
+    }
+
+    void loaderThread(ChunkStream &stream)
+    {
+        while (true)
+        {
+            int chunk = -1;
+            bool prefetched = false;
+            {
+                std::unique_lock<std::mutex> lock(stream.mutex);
+                stream.wake.wait(lock, [&stream] { return stream.quit || !stream.requests.empty() || !stream.prefetchQueue.empty(); });
+                if (stream.quit) return;
+
+                // Ray already waiting on demand chunk, prefetch only when idle
+                if (!stream.requests.empty())
+                {
+                    chunk = stream.requests.front();
+                    stream.requests.pop_front();
+                }
+                else
+                {
+                    chunk = stream.prefetchQueue.back().chunk;
+                    stream.prefetchQueue.pop_back();
+                    prefetched = true;
+                }
+            }
+
+            ChunkLoad load = (ChunkLoad){ chunk, prefetched, {} };
+            loadChunk(stream, chunk, load.runs);
+
+            std::lock_guard<std::mutex> lock(stream.mutex);
+            stream.ready.push_back(std::move(load));
+        }
+    }
+}
+
+bool Chunk::open(ChunkStream &stream, MapData &map, const unsigned char *data, std::size_t size, std::size_t memoryBytes, int tileTypes)
+{
+    // Spawn, object and light only, tile stay in the mapping
+    if (!Map::loadBinary(map, data, size, false)) return false;
+
+    MapHeader header;
+    Map::readHeader(header, data, size);
+
+    stream.tileData = data + Map::tileOffset(header);
+    stream.width = header.width;
+    stream.height = header.height;
+    stream.tileBytes = header.tileBytes;
+    stream.tileTypes = tileTypes;
+    stream.chunksX = (header.width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    stream.chunksY = (header.height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    std::size_t chunkCount = static_cast<std::size_t>(stream.chunksX) * stream.chunksY;
+    stream.slotOf.assign(chunkCount, -1);
+    stream.requested = std::vector<std::atomic<unsigned char>>(chunkCount);
+
+    // Run byte vary per chunk (uniform chunk is tiny), cap is on run byte, slot count from a typical chunk
+    stream.memoryBytes = memoryBytes;
+    int capacity = static_cast<int>(std::clamp<std::size_t>(memoryBytes / CHUNK_SLOT_BYTES, 1, chunkCount));
+    stream.slots.assign(capacity, (ChunkSlot){ -1, {}, -1, -1 });
+    stream.lastUse = std::vector<std::atomic<unsigned int>>(capacity);
+    stream.freeSlots.clear();
+    for (int i = capacity - 1; i >= 0; --i) stream.freeSlots.push_back(i);
+    stream.lruHead = -1;
+    stream.lruTail = -1;
+    stream.frame = 1;
+
+    stream.requests.clear();
+    stream.prefetchQueue.clear();
+    stream.ready.clear();
+    stream.quit = false;
+    stream.frameMisses = 0;
+    stream.pending = 0;
+    stream.stats = (ChunkStats){};
+    stream.stats.capacity = capacity;
+
+    stream.worker = std::thread(loaderThread, std::ref(stream));
+
+    std::cout << "[Chunk] Stream " << stream.width << "x" << stream.height << " map, " << capacity << " chunk slot" << std::endl;
+    return true;
+}
+
+void Chunk::close(ChunkStream &stream)
+{
+    {
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        stream.quit = true;
+    }
+    stream.wake.notify_all();
+    if (stream.worker.joinable()) stream.worker.join();
+
+    stream.slots.clear();
+    stream.slotOf.clear();
+    stream.requests.clear();
+    stream.prefetchQueue.clear();
+    stream.ready.clear();
+}
+
+void Chunk::request(ChunkStream &stream, int chunk)
+{
+    // Many ray miss the same chunk, only the first one queue it
+    unsigned char expected = 0;
+    if (!stream.requested[chunk].compare_exchange_strong(expected, 1, std::memory_order_relaxed)) return;
+
+    stream.frameMisses.fetch_add(1, std::memory_order_relaxed);
+    stream.pending.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        stream.requests.push_back(chunk);
+    }
+    stream.wake.notify_one();
+}
+
+void Chunk::pump(ChunkStream &stream)
+{
+    // Call between frame only (no cast running), this is the only place slotOf change
+
+    // ==== Metric and LRU Order of Last Frame ====
+
+    int frameHits = 0;
+    for (int slot = stream.lruHead; slot >= 0; )
+    {
+        int next = stream.slots[slot].next;
+
+        if (stream.lastUse[slot].load(std::memory_order_relaxed) == stream.frame)
+        {
+            frameHits++;
+            unlink(stream, slot);
+            pushFront(stream, slot);
+        }
+        slot = next;
+    }
+
+    stream.stats.frameHits = frameHits;
+    stream.stats.frameMisses = stream.frameMisses.exchange(0, std::memory_order_relaxed);
+    stream.stats.hits += stream.stats.frameHits;
+    stream.stats.misses += stream.stats.frameMisses;
+
+    // ==== Install Loaded Chunk ====
+
+    std::vector<ChunkLoad> ready;
+    {
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        ready.swap(stream.ready);
+    }
+
+    for (ChunkLoad &load : ready)
+    {
+        std::size_t loadBytes = Chunk::runBytes(load.runs);
+
+        // Evict least recently used until slot and byte fit, it is requested again if a ray need it
+        while (stream.lruTail >= 0 && (stream.freeSlots.empty() || stream.stats.residentBytes + loadBytes > stream.memoryBytes))
+        {
+            int evictSlot = stream.lruTail;
+            unlink(stream, evictSlot);
+
+            int evicted = stream.slots[evictSlot].chunk;
+            stream.slotOf[evicted] = -1;
+            stream.requested[evicted].store(0, std::memory_order_relaxed);
+            stream.stats.residentBytes -= Chunk::runBytes(stream.slots[evictSlot].runs);
+            stream.stats.evictions++;
+
+            stream.slots[evictSlot].chunk = -1;
+            stream.slots[evictSlot].runs = (ChunkRuns){};
+            stream.freeSlots.push_back(evictSlot);
+        }
+
+        int slot = stream.freeSlots.back();
+        stream.freeSlots.pop_back();
+
+        stream.slots[slot].chunk = load.chunk;
+        stream.slots[slot].runs = std::move(load.runs);
+        stream.stats.residentBytes += loadBytes;
+        stream.lastUse[slot].store(stream.frame, std::memory_order_relaxed);
+        pushFront(stream, slot);
+
+        stream.slotOf[load.chunk] = slot;
+        stream.pending.fetch_sub(1, std::memory_order_relaxed);
+        stream.stats.loads++;
+        if (load.prefetched) stream.stats.prefetchLoads++;
+    }
+
+    stream.stats.resident = static_cast<int>(stream.slots.size() - stream.freeSlots.size());
+    stream.stats.denseBytes = static_cast<std::size_t>(stream.stats.resident) * CHUNK_TILES * sizeof(unsigned short);
+    stream.stats.pending = stream.pending.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        stream.stats.prefetchQueued = static_cast<int>(stream.prefetchQueue.size());
+    }
+    stream.stats.hitRate = (stream.stats.hits + stream.stats.misses > 0) ? static_cast<float>(stream.stats.hits) / (stream.stats.hits + stream.stats.misses) : 1.0f;
+
+    stream.frame++;
+}
+
+void Chunk::prefetch(ChunkStream &stream, std::vector<ChunkRequest> &wanted)
+{
+    // Call between frame like pump, replace last frame prefetch list with this one
+
+    // Same chunk wanted by many player, keep the most urgent
+    std::sort(wanted.begin(), wanted.end(), [](const ChunkRequest &a, const ChunkRequest &b)
+    {
+        return a.chunk != b.chunk ? a.chunk < b.chunk : a.priority < b.priority;
+    });
+    wanted.erase(std::unique(wanted.begin(), wanted.end(), [](const ChunkRequest &a, const ChunkRequest &b) { return a.chunk == b.chunk; }), wanted.end());
+
+    {
+        std::lock_guard<std::mutex> lock(stream.mutex);
+
+        // Not started yet, prediction is outdated
+        for (const ChunkRequest &old : stream.prefetchQueue)
+        {
+            stream.requested[old.chunk].store(0, std::memory_order_relaxed);
+            stream.pending.fetch_sub(1, std::memory_order_relaxed);
+        }
+        stream.prefetchQueue.clear();
+
+        for (const ChunkRequest &request : wanted)
+        {
+            // Resident, queued on demand or loading already
+            unsigned char expected = 0;
+            if (!stream.requested[request.chunk].compare_exchange_strong(expected, 1, std::memory_order_relaxed)) continue;
+
+            stream.pending.fetch_add(1, std::memory_order_relaxed);
+            stream.prefetchQueue.push_back(request);
+        }
+
+        // Most urgent at back, loader pop from back
+        std::sort(stream.prefetchQueue.begin(), stream.prefetchQueue.end(), [](const ChunkRequest &a, const ChunkRequest &b) { return a.priority > b.priority; });
+    }
+
+    stream.wake.notify_one();
+}
+
+std::size_t Chunk::runBytes(const ChunkRuns &runs)
+{
+    // Heap byte of the run table, slot itself is in the fixed pool
+    return runs.runStart.capacity() * sizeof(unsigned long long)
+        + runs.rowRun.capacity() * sizeof(unsigned short)
+        + runs.runTile.capacity() * sizeof(unsigned short);
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Map.hpp"
+
+// Chunk edge is 1 << CHUNK_SHIFT tile (64 x 64)
+#define CHUNK_SHIFT (6)
+#define CHUNK_SIZE (1 << CHUNK_SHIFT)
+#define CHUNK_TILES (CHUNK_SIZE * CHUNK_SIZE)
+// Tile id of a tile whose chunk is not resident yet
+#define CHUNK_PENDING (-1)
+// Slot pool size is memory cap / this (typical run table of a sparse chunk)
+#define CHUNK_SLOT_BYTES (1024)
+
+// Run start of a chunk row is one 64 bit mask
+static_assert(CHUNK_SIZE == 64, "Chunk row must fit in one 64 bit run mask");
+
+typedef struct ChunkRuns
+{
+    // Row RLE: bit x of runStart[y] set when a run start at x (bit 0 always),
+    // run of row y begin at rowRun[y] in runTile, lookup is popcount (O(1))
+    // Uniform chunk (one tile id, most of a sparse world) keep only runTile[0]
+    std::vector<unsigned long long> runStart;
+    std::vector<unsigned short> rowRun;
+    std::vector<unsigned short> runTile;
+} ChunkRuns;
+
+typedef struct ChunkSlot
+{
+    // Chunk index in this slot (-1 free) and its tile run
+    int chunk;
+    ChunkRuns runs;
+    // LRU list, front is most recently used
+    int prev;
+    int next;
+} ChunkSlot;
+
+typedef struct ChunkLoad
+{
+    int chunk;
+    bool prefetched;
+    ChunkRuns runs;
+} ChunkLoad;
+
+typedef struct ChunkRequest
+{
+    // Smaller priority load first (estimated frame until visible)
+    int chunk;
+    float priority;
+} ChunkRequest;
+
+typedef struct ChunkStats
+{
+    // Last frame: distinct resident chunk touched (hit) and chunk requested (miss)
+    int frameHits;
+    int frameMisses;
+    // Since open
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long loads;
+    unsigned long long prefetchLoads;
+    unsigned long long evictions;
+    float hitRate;
+    // Residency
+    int resident;
+    int capacity;
+    int pending;
+    int prefetchQueued;
+    // Run table byte of resident chunk (row RLE), and same chunk as plain u16 tile
+    std::size_t residentBytes;
+    std::size_t denseBytes;
+} ChunkStats;
+
+typedef struct ChunkStream
+{
+    // Tile block of the binary map, row major (stay in the mapping, never copied whole)
+    const unsigned char *tileData;
+    int width;
+    int height;
+    unsigned int tileBytes;
+    // Tile id at or above this load as empty
+    int tileTypes;
+
+    int chunksX;
+    int chunksY;
+
+    // Per chunk: slot (-1 not resident) and miss already queued flag
+    // slotOf only change in pump, cast thread read it lock free during the frame
+    std::vector<int> slotOf;
+    std::vector<std::atomic<unsigned char>> requested;
+
+    // Slot pool, frame stamp of last use per slot, evict when run byte reach the memory cap
+    std::size_t memoryBytes;
+    std::vector<ChunkSlot> slots;
+    std::vector<std::atomic<unsigned int>> lastUse;
+    std::vector<int> freeSlots;
+    int lruHead;
+    int lruTail;
+    unsigned int frame;
+
+    // Background loader, demand miss first then prefetch (most urgent at back)
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<int> requests;
+    std::vector<ChunkRequest> prefetchQueue;
+    std::vector<ChunkLoad> ready;
+    bool quit;
+
+    std::atomic<int> frameMisses;
+    std::atomic<int> pending;
+    ChunkStats stats;
+} ChunkStream;
+
+namespace Chunk
+{
+    bool open(ChunkStream &stream, MapData &map, const unsigned char *data, std::size_t size, std::size_t memoryBytes, int tileTypes);
+    void close(ChunkStream &stream);
+    void request(ChunkStream &stream, int chunk);
+    void pump(ChunkStream &stream);
+    void prefetch(ChunkStream &stream, std::vector<ChunkRequest> &wanted);
+    std::size_t runBytes(const ChunkRuns &runs);
+
+    // Tile at chunk local (x, y) and its run [left, right) in the row
+    inline int run(const ChunkRuns &runs, int x, int y, int &left, int &right)
+    {
+        if (runs.runStart.empty())
+        {
+            left = 0;
+            right = CHUNK_SIZE;
+            return runs.runTile[0];
+        }
+
+        // Run start at or before x, last one is the run of x
+        unsigned long long starts = runs.runStart[y];
+        unsigned long long before = starts & (~0ull >> (CHUNK_SIZE - 1 - x));
+        unsigned long long after = (x + 1 < CHUNK_SIZE) ? starts >> (x + 1) : 0;
+
+        left = CHUNK_SIZE - 1 - std::countl_zero(before);
+        right = (after != 0) ? x + 1 + std::countr_zero(after) : CHUNK_SIZE;
+
+        return runs.runTile[runs.rowRun[y] + std::popcount(before) - 1];
+    }
+
+    // Called per ray step from cast thread, inline and lock free on hit
+    // Run [runLeft, runRight) is in map tile, cut at chunk and map edge
+    inline int tileRun(ChunkStream &stream, int x, int y, int &runLeft, int &runRight)
+    {
+        int chunk = (y >> CHUNK_SHIFT) * stream.chunksX + (x >> CHUNK_SHIFT);
+        int slot = stream.slotOf[chunk];
+
+        if (slot < 0)
+        {
+            Chunk::request(stream, chunk);
+            runLeft = x;
+            runRight = x + 1;
+            return CHUNK_PENDING;
+        }
+
+        // Stamp once per frame, no store (cache line bounce) on every step
+        std::atomic<unsigned int> &used = stream.lastUse[slot];
+        if (used.load(std::memory_order_relaxed) != stream.frame) used.store(stream.frame, std::memory_order_relaxed);
+
+        int tile = Chunk::run(stream.slots[slot].runs, x & (CHUNK_SIZE - 1), y & (CHUNK_SIZE - 1), runLeft, runRight);
+
+        int chunkLeft = x & ~(CHUNK_SIZE - 1);
+        runLeft += chunkLeft;
+        runRight = std::min(runRight + chunkLeft, stream.width);
+
+        return tile;
+    }
+
+    inline int tile(ChunkStream &stream, int x, int y)
+    {
+        int runLeft = 0;
+        int runRight = 0;
+        return Chunk::tileRun(stream, x, y, runLeft, runRight);
+    }
+}
\ No newline at end of file
@@ -2,21 +2,74 @@
 
 #include <iostream>
 #include <filesystem>
+#include <string>
+#include <unordered_map>
 
-const char *File::getPathFile(const char *path, bool isShowPath)
+namespace
 {
-    bool isFileNotfound = false;
-    static std::string finalPath;
-    std::filesystem::path path1 = std::filesystem::current_path() / path;
-    std::filesystem::path path2 = std::filesystem::current_path().parent_path() / path;
-
-    if (std::filesystem::exists(path1)) finalPath = path1.string();
-    else if (std::filesystem::exists(path2)) finalPath = path2.string();
-    else
+    // Heterogeneous hash, lookup by string_view without build std::string
+    struct PathHash
+    {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view path) const { return std::hash<std::string_view>{}(path); }
+    };
+
+    using AssetIndex = std::unordered_map<std::string, std::string, PathHash, std::equal_to<>>;
+
+    AssetIndex scanAssets()
+    {
+        AssetIndex index;
+
+        // Same root order with old lookup: working dir first, then parent dir
+        const std::filesystem::path roots[] = {
+            std::filesystem::current_path(),
+            std::filesystem::current_path().parent_path()
+        };
+
+        for (const std::filesystem::path &root : roots)
+        {
+            std::error_code error;
+            if (!std::filesystem::is_directory(root / "assets", error)) continue;
+
+            // Directory is indexed too, for file watcher
+            index.try_emplace("assets", (root / "assets").string());
+
+            for (const auto &entry : std::filesystem::recursive_directory_iterator(root / "assets", error))
+            {
+                if (!entry.is_regular_file(error) && !entry.is_directory(error)) continue;
+
+                // Logical name is path relative to root, always with '/'
+                std::string name = entry.path().lexically_relative(root).generic_string();
+                index.try_emplace(std::move(name), entry.path().string());
+            }
+        }
+
+        return index;
+    }
+
+    const AssetIndex &assetIndex()
     {
-        finalPath.clear();
-        isFileNotfound = true;
+        // Scan once, static init is thread-safe, after that index is read only
+        static const AssetIndex index = scanAssets();
+        return index;
     }
+}
+
+std::string_view File::resolve(std::string_view path)
+{
+    const AssetIndex &index = assetIndex();
+
+    auto found = index.find(path);
+    if (found == index.end()) return std::string_view();
+
+    return found->second;
+}
+
+const char *File::getPathFile(const char *path, bool isShowPath)
+{
+    // Pointer stay valid for whole program, index never change after scan
+    std::string_view finalPath = File::resolve(path);
+    bool isFileNotfound = finalPath.empty();
 
     if (isShowPath)
     {
@@ -24,5 +77,5 @@ const char *File::getPathFile(const char *path, bool isShowPath)
         else std::cout << "[File] Path: " << finalPath << std::endl;
     }
     
-    return finalPath.c_str();
+    return isFileNotfound ? "" : finalPath.data();
 }
\ No newline at end of file
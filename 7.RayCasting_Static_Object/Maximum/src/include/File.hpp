@@ -1,6 +1,9 @@
 #pragma once
 
+#include <string_view>
+
 namespace File
 {
      const char *getPathFile(const char *path, bool isShowPath);
+     std::string_view resolve(std::string_view path);
 }
\ No newline at end of file
@@ -0,0 +1,339 @@
+#include "Map.hpp"
+#include "Pack.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool Map::load(MapData &map, const char *path)
+{
+    // Map whole file, binary tile is copied in one pass
+    MappedFile file = Pack::mapFile(path);
+    if (file.data == nullptr)
+    {
+        std::cerr << "[Map] Error: Can not open map " << path << std::endl;
+        return false;
+    }
+
+    bool isLoaded = Map::loadFromMemory(map, file.data, file.size);
+    Pack::unmapFile(file);
+
+    return isLoaded;
+}
+
+bool Map::loadFromMemory(MapData &map, const unsigned char *data, std::size_t size)
+{
+    // Binary start with magic, everything else is text
+    if (size >= 4 && std::memcmp(data, MAP_MAGIC, 4) == 0) return Map::loadBinary(map, data, size, true);
+
+    return Map::loadText(map, reinterpret_cast<const char *>(data), size);
+}
+
+bool Map::loadText(MapData &map, const char *text, std::size_t size)
+{
+    /*
+    Text map, one command per line ('#' comment):
+    size <width> <height>
+    spawn <x> <y>
+    object <x> <y> <textureId> <scale> <radius>
+    light <x> <y> <radius> <intensity>
+    tiles
+    <width tile id per line, height line>
+    */
+    map = (MapData){};
+
+    std::istringstream in(std::string(text, size));
+    std::string line;
+
+    while (std::getline(in, line))
+    {
+        std::istringstream words(line);
+        std::string command;
+        if (!(words >> command) || command[0] == '#') continue;
+
+        if (command == "size")
+        {
+            words >> map.width >> map.height;
+        }
+        else if (command == "spawn")
+        {
+            MapSpawn spawn = {};
+            words >> spawn.x >> spawn.y;
+            map.spawns.push_back(spawn);
+        }
+        else if (command == "object")
+        {
+            MapObject object = {};
+            words >> object.x >> object.y >> object.textureId >> object.scale >> object.radius;
+            map.objects.push_back(object);
+        }
+        else if (command == "light")
+        {
+            MapLight light = {};
+            words >> light.x >> light.y >> light.radius >> light.intensity;
+            map.lights.push_back(light);
+        }
+        else if (command == "tiles")
+        {
+            if (map.width <= 0 || map.height <= 0) break;
+
+            // Only tile really read count, short or garbled block is an error (not floor)
+            const std::size_t tileCount = static_cast<std::size_t>(map.width) * map.height;
+            map.tiles.reserve(tileCount);
+            while (map.tiles.size() < tileCount)
+            {
+                long long tile = 0;
+                if (!(in >> tile) || tile < 0 || tile > 0xFFFF) break;
+                map.tiles.push_back(static_cast<unsigned short>(tile));
+            }
+            break;
+        }
+    }
+
+    if (map.width <= 0 || map.height <= 0 || map.tiles.size() != static_cast<std::size_t>(map.width) * map.height)
+    {
+        std::cerr << "[Map] Error: Invalid text map" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool Map::readHeader(MapHeader &header, const unsigned char *data, std::size_t size)
+{
+    if (size < sizeof(MapHeader) || std::memcmp(data, MAP_MAGIC, 4) != 0) return false;
+
+    std::memcpy(&header, data, sizeof(header));
+
+    return header.version == MAP_VERSION && header.width > 0 && header.height > 0 && (header.tileBytes == 1 || header.tileBytes == 2);
+}
+
+std::size_t Map::tileOffset(const MapHeader &header)
+{
+    return sizeof(MapHeader)
+        + header.spawnCount * sizeof(MapSpawn)
+        + header.objectCount * sizeof(MapObject)
+        + header.lightCount * sizeof(MapLight);
+}
+
+bool Map::loadBinary(MapData &map, const unsigned char *data, std::size_t size, bool withTiles)
+{
+    map = (MapData){};
+
+    MapHeader header;
+    if (!Map::readHeader(header, data, size))
+    {
+        std::cerr << "[Map] Error: Invalid binary map" << std::endl;
+        return false;
+    }
+
+    std::size_t tileCount = static_cast<std::size_t>(header.width) * header.height;
+    if (Map::tileOffset(header) + tileCount * header.tileBytes > size)
+    {
+        std::cerr << "[Map] Error: Truncated binary map" << std::endl;
+        return false;
+    }
+
+    map.width = header.width;
+    map.height = header.height;
+
+    // Fixed size record, read straight without parse
+    const unsigned char *cursor = data + sizeof(MapHeader);
+
+    map.spawns.resize(header.spawnCount);
+    std::memcpy(map.spawns.data(), cursor, header.spawnCount * sizeof(MapSpawn));
+    cursor += header.spawnCount * sizeof(MapSpawn);
+
+    map.objects.resize(header.objectCount);
+    std::memcpy(map.objects.data(), cursor, header.objectCount * sizeof(MapObject));
+    cursor += header.objectCount * sizeof(MapObject);
+
+    map.lights.resize(header.lightCount);
+    std::memcpy(map.lights.data(), cursor, header.lightCount * sizeof(MapLight));
+    cursor += header.lightCount * sizeof(MapLight);
+
+    // Streamed map keep tile in the file, only header and record are read
+    if (!withTiles) return true;
+
+    // Construct straight from the mapping (no zero fill first), u8 widen in the same pass
+    if (header.tileBytes == 2)
+    {
+        const unsigned short *tiles = reinterpret_cast<const unsigned short *>(cursor);
+        map.tiles.assign(tiles, tiles + tileCount);
+    }
+    else
+    {
+        map.tiles.assign(cursor, cursor + tileCount);
+    }
+
+    return true;
+}
+
+bool Map::saveText(const MapData &map, const char *path)
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+
+    out << "size " << map.width << " " << map.height << "\n";
+    for (const MapSpawn &spawn : map.spawns) out << "spawn " << spawn.x << " " << spawn.y << "\n";
+    for (const MapObject &object : map.objects) out << "object " << object.x << " " << object.y << " " << object.textureId << " " << object.scale << " " << object.radius << "\n";
+    for (const MapLight &light : map.lights) out << "light " << light.x << " " << light.y << " " << light.radius << " " << light.intensity << "\n";
+
+    out << "tiles\n";
+    for (int i = 0; i < map.height; ++i)
+    {
+        for (int j = 0; j < map.width; ++j) out << map.tiles[static_cast<std::size_t>(i) * map.width + j] << (j + 1 < map.width ? " " : "\n");
+    }
+
+    return static_cast<bool>(out);
+}
+
+bool Map::saveBinary(const MapData &map, const char *path)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    std::vector<unsigned char> bytes;
+    Map::encodeBinary(map, bytes);
+    out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    return static_cast<bool>(out);
+}
+
+bool Map::convert(const char *sourcePath, const char *outputPath)
+{
+    MappedFile file = Pack::mapFile(sourcePath);
+    if (file.data == nullptr)
+    {
+        std::cerr << "[Map] Error: Can not open map " << sourcePath << std::endl;
+        return false;
+    }
+
+    // Text map to binary map, binary map back to text (for edit)
+    bool isBinary = file.size >= 4 && std::memcmp(file.data, MAP_MAGIC, 4) == 0;
+
+    MapData map;
+    bool isLoaded = Map::loadFromMemory(map, file.data, file.size);
+    Pack::unmapFile(file);
+
+    if (!isLoaded) return false;
+
+    if (!(isBinary ? Map::saveText(map, outputPath) : Map::saveBinary(map, outputPath)))
+    {
+        std::cerr << "[Map] Error: Can not write " << outputPath << std::endl;
+        return false;
+    }
+
+    std::cout << "[Map] Converted " << sourcePath << " (" << map.width << "x" << map.height << ") to " << (isBinary ? "text" : "binary") << " map " << outputPath << std::endl;
+
+    return true;
+}
+
+void Map::encodeBinary(const MapData &map, std::vector<unsigned char> &bytes)
+{
+    MapHeader header = {};
+    std::memcpy(header.magic, MAP_MAGIC, 4);
+    header.version = MAP_VERSION;
+    header.width = map.width;
+    header.height = map.height;
+    header.spawnCount = static_cast<unsigned int>(map.spawns.size());
+    header.objectCount = static_cast<unsigned int>(map.objects.size());
+    header.lightCount = static_cast<unsigned int>(map.lights.size());
+
+    // Smallest tile id size that fit every tile
+    header.tileBytes = 1;
+    for (unsigned short tile : map.tiles) if (tile > 255) header.tileBytes = 2;
+
+    bytes.clear();
+    bytes.reserve(Map::tileOffset(header) + map.tiles.size() * header.tileBytes);
+
+    auto append = [&bytes](const void *data, std::size_t size)
+    {
+        const unsigned char *begin = static_cast<const unsigned char *>(data);
+        bytes.insert(bytes.end(), begin, begin + size);
+    };
+
+    append(&header, sizeof(header));
+    append(map.spawns.data(), map.spawns.size() * sizeof(MapSpawn));
+    append(map.objects.data(), map.objects.size() * sizeof(MapObject));
+    append(map.lights.data(), map.lights.size() * sizeof(MapLight));
+
+    if (header.tileBytes == 2) append(map.tiles.data(), map.tiles.size() * 2);
+    else bytes.insert(bytes.end(), map.tiles.begin(), map.tiles.end());
+}
+
+bool Map::readCompiled(CompiledMap &compiled, const unsigned char *data, std::size_t size, unsigned long long buildKey)
+{
+    compiled = (CompiledMap){};
+
+    if (data == nullptr || size < sizeof(CompiledHeader) || std::memcmp(data, MAPC_MAGIC, 4) != 0) return false;
+
+    const CompiledHeader *header = reinterpret_cast<const CompiledHeader *>(data);
+
+    // Other game build parameter: derived data is not valid anymore
+    if (header->version != MAPC_VERSION || header->buildKey != buildKey) return false;
+
+    for (int i = 0; i < MAP_SECTION_COUNT; ++i)
+    {
+        // Aligned for direct copy of 64 bit word
+        if (header->offset[i] % MAPC_ALIGNMENT != 0 || header->offset[i] > size || header->size[i] > size - header->offset[i]) return false;
+
+        compiled.section[i] = (PackBlob){ data + header->offset[i], static_cast<std::size_t>(header->size[i]) };
+    }
+
+    compiled.header = header;
+
+    return true;
+}
+
+bool Map::stampSource(CompiledHeader &header, const char *sourcePath)
+{
+    MappedFile file = Pack::mapFile(sourcePath);
+    if (file.data == nullptr) return false;
+
+    header.source = (SourceKey){ file.size, file.mtime, Pack::hash(file.data, file.size) };
+    Pack::unmapFile(file);
+
+    return true;
+}
+
+bool Map::isSourceCurrent(const CompiledHeader &header, PackBlob source, long long mtime)
+{
+    // No source map at all, compiled map is the only copy
+    if (source.data == nullptr) return true;
+
+    // Same mtime is enough (no read), else same content hash (file touched or packed but not changed)
+    return header.source.size == source.size
+        && (header.source.mtime == mtime || header.source.hash == Pack::hash(source.data, source.size));
+}
+
+bool Map::saveCompiled(const char *path, CompiledHeader header, const std::array<PackBlob, MAP_SECTION_COUNT> &sections)
+{
+    std::memcpy(header.magic, MAPC_MAGIC, 4);
+    header.version = MAPC_VERSION;
+
+    auto align = [](unsigned long long offset) { return (offset + MAPC_ALIGNMENT - 1) / MAPC_ALIGNMENT * MAPC_ALIGNMENT; };
+
+    unsigned long long offset = align(sizeof(CompiledHeader));
+    for (int i = 0; i < MAP_SECTION_COUNT; ++i)
+    {
+        header.offset[i] = offset;
+        header.size[i] = sections[i].size;
+        offset = align(offset + sections[i].size);
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    for (int i = 0; i < MAP_SECTION_COUNT; ++i)
+    {
+        // Zero padding up to aligned section start
+        while (static_cast<unsigned long long>(out.tellp()) < header.offset[i]) out.put('\0');
+        out.write(reinterpret_cast<const char *>(sections[i].data), static_cast<std::streamsize>(sections[i].size));
+    }
+
+    return static_cast<bool>(out);
+}
\ No newline at end of file
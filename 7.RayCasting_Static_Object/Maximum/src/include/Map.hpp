@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Pack.hpp"
+
+// Binary map: header, spawn, object, light, then tile row by row (u8 or u16)
+#define MAP_MAGIC "RCMP"
+#define MAP_VERSION (1)
+
+typedef struct MapHeader
+{
+    char magic[4];
+    unsigned int version;
+    int width;
+    int height;
+    // Byte per tile id, 1 (u8) or 2 (u16)
+    unsigned int tileBytes;
+    unsigned int spawnCount;
+    unsigned int objectCount;
+    unsigned int lightCount;
+} MapHeader;
+
+// Compiled map: header, then aligned section (source binary map and derived data baked offline)
+#define MAPC_MAGIC "RCMC"
+#define MAPC_VERSION (2)
+#define MAPC_ALIGNMENT (64)
+
+typedef enum MapSection
+{
+    // Source map in binary form (header, record, tile)
+    MAP_SECTION_SOURCE = 0,
+    MAP_SECTION_SOLID,
+    MAP_SECTION_DISTANCE,
+    MAP_SECTION_DOOR,
+    MAP_SECTION_FACE_LIGHT,
+    MAP_SECTION_FLOOR_LIGHT,
+    MAP_SECTION_COUNT
+} MapSection;
+
+typedef struct CompiledHeader
+{
+    char magic[4];
+    unsigned int version;
+    // Hash of game build parameter (tile size, light, ...), other key = compile again
+    unsigned long long buildKey;
+    // Source map at compile time, checked against the source blob the game load (pack entry or loose file)
+    SourceKey source;
+    unsigned long long offset[MAP_SECTION_COUNT];
+    unsigned long long size[MAP_SECTION_COUNT];
+} CompiledHeader;
+
+typedef struct CompiledMap
+{
+    // Point into the mapping, no copy
+    const CompiledHeader *header;
+    std::array<PackBlob, MAP_SECTION_COUNT> section;
+} CompiledMap;
+
+typedef struct MapSpawn
+{
+    // Tile coordinate
+    float x;
+    float y;
+} MapSpawn;
+
+typedef struct MapObject
+{
+    // Tile coordinate (center of tile is + 0.5)
+    float x;
+    float y;
+    int textureId;
+    float scale;
+    float radius;
+} MapObject;
+
+typedef struct MapLight
+{
+    // Tile coordinate, radius in tile
+    float x;
+    float y;
+    float radius;
+    float intensity;
+} MapLight;
+
+typedef struct MapData
+{
+    int width;
+    int height;
+    // Row major, width * height
+    std::vector<unsigned short> tiles;
+    std::vector<MapSpawn> spawns;
+    std::vector<MapObject> objects;
+    std::vector<MapLight> lights;
+} MapData;
+
+namespace Map
+{
+    bool load(MapData &map, const char *path);
+    bool loadFromMemory(MapData &map, const unsigned char *data, std::size_t size);
+    bool loadText(MapData &map, const char *text, std::size_t size);
+    bool loadBinary(MapData &map, const unsigned char *data, std::size_t size, bool withTiles);
+    bool readHeader(MapHeader &header, const unsigned char *data, std::size_t size);
+    std::size_t tileOffset(const MapHeader &header);
+    bool saveText(const MapData &map, const char *path);
+    bool saveBinary(const MapData &map, const char *path);
+    bool convert(const char *sourcePath, const char *outputPath);
+    void encodeBinary(const MapData &map, std::vector<unsigned char> &bytes);
+    bool readCompiled(CompiledMap &compiled, const unsigned char *data, std::size_t size, unsigned long long buildKey);
+    bool stampSource(CompiledHeader &header, const char *sourcePath);
+    bool isSourceCurrent(const CompiledHeader &header, PackBlob source, long long mtime);
+    bool saveCompiled(const char *path, CompiledHeader header, const std::array<PackBlob, MAP_SECTION_COUNT> &sections);
+}
\ No newline at end of file
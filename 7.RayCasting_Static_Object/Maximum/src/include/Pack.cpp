@@ -0,0 +1,152 @@
+#include "Pack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+MappedFile Pack::mapFile(const char *path)
+{
+    MappedFile mapped = {};
+    if (path == nullptr || path[0] == '\0') return mapped;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return mapped;
+
+    LARGE_INTEGER fileSize;
+    FILETIME writeTime;
+    GetFileSizeEx(file, &fileSize);
+    GetFileTime(file, nullptr, nullptr, &writeTime);
+
+    HANDLE mapping = (fileSize.QuadPart > 0) ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);
+    if (mapping == nullptr) return mapped;
+
+    mapped.data = static_cast<const unsigned char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (mapped.data == nullptr)
+    {
+        CloseHandle(mapping);
+        return (MappedFile){};
+    }
+
+    mapped.size = static_cast<std::size_t>(fileSize.QuadPart);
+    // FILETIME is 100 ns since 1601, keep second since unix epoch
+    mapped.mtime = static_cast<long long>(((static_cast<unsigned long long>(writeTime.dwHighDateTime) << 32) | writeTime.dwLowDateTime) / 10000000ull) - 11644473600ll;
+    mapped.handle = mapping;
+#else
+    int file = ::open(path, O_RDONLY);
+    if (file < 0) return mapped;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size <= 0)
+    {
+        ::close(file);
+        return mapped;
+    }
+
+    void *mapping = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (mapping == MAP_FAILED) return mapped;
+
+    mapped.data = static_cast<const unsigned char *>(mapping);
+    mapped.size = static_cast<std::size_t>(info.st_size);
+    mapped.mtime = static_cast<long long>(info.st_mtime);
+#endif
+
+    return mapped;
+}
+
+void Pack::unmapFile(MappedFile &file)
+{
+    if (file.data != nullptr)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(file.data);
+        CloseHandle(static_cast<HANDLE>(file.handle));
+#else
+        munmap(const_cast<unsigned char *>(file.data), file.size);
+#endif
+    }
+
+    file = (MappedFile){};
+}
+
+AssetPack Pack::open(const char *path)
+{
+    AssetPack pack = {};
+
+    // ==== Map Whole File (read only) ====
+
+    pack.file = Pack::mapFile(path);
+    if (pack.file.data == nullptr) return pack;
+
+    pack.data = pack.file.data;
+    pack.size = pack.file.size;
+
+    // ==== Validate Header and Index ====
+
+    pack.header = reinterpret_cast<const PackHeader *>(pack.data);
+
+    bool isValid = pack.size >= sizeof(PackHeader)
+        && std::memcmp(pack.header->magic, PACK_MAGIC, 4) == 0
+        && pack.header->version == PACK_VERSION
+        && pack.header->indexOffset + pack.header->count * sizeof(PackEntry) <= pack.size;
+
+    if (!isValid)
+    {
+        std::cerr << "[Pack] Error: Invalid asset pack " << path << std::endl;
+        Pack::close(pack);
+        return pack;
+    }
+
+    pack.entries = reinterpret_cast<const PackEntry *>(pack.data + pack.header->indexOffset);
+
+    return pack;
+}
+
+void Pack::close(AssetPack &pack)
+{
+    Pack::unmapFile(pack.file);
+    pack = (AssetPack){};
+}
+
+PackBlob Pack::find(const AssetPack &pack, std::string_view name)
+{
+    if (pack.entries == nullptr) return (PackBlob){};
+
+    // Index is sorted by name at build time, binary search touch only few index page
+    const PackEntry *first = pack.entries;
+    const PackEntry *last = pack.entries + pack.header->count;
+
+    const PackEntry *found = std::lower_bound(first, last, name, [](const PackEntry &entry, std::string_view key)
+    {
+        return std::string_view(entry.name, strnlen(entry.name, PACK_NAME_MAX)) < key;
+    });
+
+    if (found == last || std::string_view(found->name, strnlen(found->name, PACK_NAME_MAX)) != name) return (PackBlob){};
+    if (found->offset + found->size > pack.size) return (PackBlob){};
+
+    return (PackBlob){ pack.data + found->offset, static_cast<std::size_t>(found->size) };
+}
+
+unsigned long long Pack::hash(const unsigned char *data, std::size_t size)
+{
+    // FNV-1a 64 bit
+    unsigned long long value = 14695981039346656037ull;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        value ^= data[i];
+        value *= 1099511628211ull;
+    }
+    return value;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// Pack file: header, sorted index, then blob aligned to page (only touched page is read)
+#define PACK_MAGIC "RCPK"
+#define PACK_VERSION (1)
+#define PACK_ALIGNMENT (4096)
+#define PACK_NAME_MAX (120)
+
+typedef struct PackHeader
+{
+    char magic[4];
+    unsigned int version;
+    unsigned int count;
+    unsigned int alignment;
+    unsigned long long indexOffset;
+} PackHeader;
+
+typedef struct PackEntry
+{
+    // Logical name, same with File::resolve ("assets/...")
+    char name[PACK_NAME_MAX];
+    unsigned long long offset;
+    unsigned long long size;
+} PackEntry;
+
+typedef struct PackBlob
+{
+    // Point into the mapping, no copy
+    const unsigned char *data;
+    std::size_t size;
+} PackBlob;
+
+typedef struct MappedFile
+{
+    const unsigned char *data;
+    std::size_t size;
+    // Last write time (second) and platform mapping handle
+    long long mtime;
+    void *handle;
+} MappedFile;
+
+typedef struct SourceKey
+{
+    // Size and mtime check first (no read), hash only when mtime change
+    unsigned long long size;
+    long long mtime;
+    unsigned long long hash;
+} SourceKey;
+
+typedef struct AssetPack
+{
+    MappedFile file;
+    const unsigned char *data;
+    std::size_t size;
+    const PackHeader *header;
+    const PackEntry *entries;
+} AssetPack;
+
+namespace Pack
+{
+    MappedFile mapFile(const char *path);
+    void unmapFile(MappedFile &file);
+    AssetPack open(const char *path);
+    void close(AssetPack &pack);
+    PackBlob find(const AssetPack &pack, std::string_view name);
+    unsigned long long hash(const unsigned char *data, std::size_t size);
+}
\ No newline at end of file
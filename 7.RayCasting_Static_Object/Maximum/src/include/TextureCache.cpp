@@ -0,0 +1,187 @@
+#include "TextureCache.hpp"
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    typedef struct CacheWrite
+    {
+        std::string path;
+        SourceKey key;
+        int width;
+        int height;
+        std::vector<unsigned char> pixels;
+        std::vector<int> columnOffset;
+        std::vector<unsigned short> spans;
+    } CacheWrite;
+
+    // Single background writer and its queue, joined by TextureCache::flush
+    std::mutex writerMutex;
+    std::condition_variable writerWake;
+    std::deque<CacheWrite> writeQueue;
+    std::thread writer;
+    bool writerQuit = false;
+
+    unsigned long long alignOffset(unsigned long long offset)
+    {
+        return (offset + 15) / 16 * 16;
+    }
+
+    void writeCache(const CacheWrite &write)
+    {
+        TexCacheHeader header = {};
+        std::memcpy(header.magic, TEXCACHE_MAGIC, 4);
+        header.version = TEXCACHE_VERSION;
+        header.key = write.key;
+        header.width = write.width;
+        header.height = write.height;
+        header.spanCount = static_cast<unsigned int>(write.spans.size() / 2);
+        header.pixelOffset = alignOffset(sizeof(TexCacheHeader));
+        header.columnOffset = alignOffset(header.pixelOffset + write.pixels.size());
+        header.spanOffset = alignOffset(header.columnOffset + write.columnOffset.size() * sizeof(int));
+
+        std::error_code error;
+        std::filesystem::create_directories(TEXCACHE_DIR, error);
+
+        // Write beside then rename, reader never see half written file
+        std::string temp = write.path + ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            if (!out) return;
+
+            auto writeAt = [&out](unsigned long long offset, const void *data, std::size_t size)
+            {
+                while (static_cast<unsigned long long>(out.tellp()) < offset) out.put('\0');
+                out.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+            };
+
+            writeAt(0, &header, sizeof(header));
+            writeAt(header.pixelOffset, write.pixels.data(), write.pixels.size());
+            writeAt(header.columnOffset, write.columnOffset.data(), write.columnOffset.size() * sizeof(int));
+            writeAt(header.spanOffset, write.spans.data(), write.spans.size() * sizeof(unsigned short));
+        }
+
+        std::filesystem::rename(temp, write.path, error);
+        if (error) std::cerr << "[TextureCache] Error: Can not write " << write.path << std::endl;
+    }
+
+    void writerThread()
+    {
+        while (true)
+        {
+            CacheWrite write;
+            {
+                std::unique_lock<std::mutex> lock(writerMutex);
+                writerWake.wait(lock, [] { return writerQuit || !writeQueue.empty(); });
+                if (writeQueue.empty()) return;
+
+                write = std::move(writeQueue.front());
+                writeQueue.pop_front();
+            }
+
+            // Same file queued twice is written in order, newest win
+            writeCache(write);
+        }
+    }
+}
+
+std::string TextureCache::cachePath(std::string_view name)
+{
+    // "assets/textures/brick/a.png" -> "cache/textures/assets_textures_brick_a.png.tex"
+    std::string file(name);
+    for (char &c : file) if (c == '/' || c == '\\' || c == ':') c = '_';
+
+    return std::string(TEXCACHE_DIR) + "/" + file + ".tex";
+}
+
+bool TextureCache::open(TexCacheView &view, std::string_view name, SourceKey key)
+{
+    view = (TexCacheView){};
+    view.file = Pack::mapFile(TextureCache::cachePath(name).c_str());
+    if (view.file.data == nullptr) return false;
+
+    const TexCacheHeader *header = reinterpret_cast<const TexCacheHeader *>(view.file.data);
+
+    bool isValid = view.file.size >= sizeof(TexCacheHeader)
+        && std::memcmp(header->magic, TEXCACHE_MAGIC, 4) == 0
+        && header->version == TEXCACHE_VERSION
+        && header->key.size == key.size
+        // Same mtime is enough, else same content hash (file touched but not changed)
+        && (header->key.mtime == key.mtime || (key.hash != 0 && header->key.hash == key.hash))
+        && header->width > 0 && header->height > 0
+        // Every table inside the file (no offset + size overflow) and aligned for its type
+        && header->pixelOffset <= view.file.size && 4ull * header->width * header->height <= view.file.size - header->pixelOffset
+        && header->columnOffset <= view.file.size && sizeof(int) * (header->width + 1ull) <= view.file.size - header->columnOffset
+        && header->spanOffset <= view.file.size && 2 * sizeof(unsigned short) * static_cast<unsigned long long>(header->spanCount) <= view.file.size - header->spanOffset
+        && header->columnOffset % sizeof(int) == 0 && header->spanOffset % sizeof(unsigned short) == 0;
+
+    if (!isValid)
+    {
+        TextureCache::close(view);
+        return false;
+    }
+
+    // Header fit the file, table pointer is inside the mapping now
+    const int *columnOffset = reinterpret_cast<const int *>(view.file.data + header->columnOffset);
+    const unsigned short *spans = reinterpret_cast<const unsigned short *>(view.file.data + header->spanOffset);
+
+    // Span table is indexed straight at render time: offset from 0 to spanCount never going back,
+    // every span inside the column height
+    isValid = columnOffset[0] == 0 && static_cast<unsigned int>(columnOffset[header->width]) == header->spanCount;
+    for (int x = 0; isValid && x < header->width; ++x) isValid = columnOffset[x] <= columnOffset[x + 1];
+    for (unsigned int i = 0; isValid && i < header->spanCount; ++i) isValid = spans[i * 2] < spans[i * 2 + 1] && spans[i * 2 + 1] <= header->height;
+
+    if (!isValid)
+    {
+        TextureCache::close(view);
+        return false;
+    }
+
+    view.header = header;
+    view.pixels = view.file.data + header->pixelOffset;
+    view.columnOffset = columnOffset;
+    view.spans = spans;
+
+    return true;
+}
+
+void TextureCache::close(TexCacheView &view)
+{
+    Pack::unmapFile(view.file);
+    view = (TexCacheView){};
+}
+
+void TextureCache::store(std::string_view name, SourceKey key, int width, int height, std::vector<unsigned char> pixels, std::vector<int> columnOffset, std::vector<unsigned short> spans)
+{
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        writeQueue.push_back((CacheWrite){ TextureCache::cachePath(name), key, width, height, std::move(pixels), std::move(columnOffset), std::move(spans) });
+
+        // One writer for every store, started on first use (again after flush)
+        if (!writer.joinable())
+        {
+            writerQuit = false;
+            writer = std::thread(writerThread);
+        }
+    }
+    writerWake.notify_one();
+}
+
+void TextureCache::flush()
+{
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        writerQuit = true;
+    }
+    writerWake.notify_one();
+
+    // Writer drain the queue before it stop
+    if (writer.joinable()) writer.join();
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Pack.hpp"
+
+// Decoded texture cache: RGBA8 pixel and opaque span table, read back with mmap
+#define TEXCACHE_MAGIC "RCTC"
+#define TEXCACHE_VERSION (1)
+#define TEXCACHE_DIR "cache/textures"
+
+typedef struct TexCacheHeader
+{
+    char magic[4];
+    unsigned int version;
+    SourceKey key;
+    int width;
+    int height;
+    unsigned int spanCount;
+    unsigned int reserved;
+    // Pixel (width * height RGBA8), column offset (width + 1 int), span (start, end pair)
+    unsigned long long pixelOffset;
+    unsigned long long columnOffset;
+    unsigned long long spanOffset;
+} TexCacheHeader;
+
+typedef struct TexCacheView
+{
+    MappedFile file;
+    const TexCacheHeader *header;
+    const unsigned char *pixels;
+    const int *columnOffset;
+    const unsigned short *spans;
+} TexCacheView;
+
+namespace TextureCache
+{
+    std::string cachePath(std::string_view name);
+    bool open(TexCacheView &view, std::string_view name, SourceKey key);
+    void close(TexCacheView &view);
+    void store(std::string_view name, SourceKey key, int width, int height, std::vector<unsigned char> pixels, std::vector<int> columnOffset, std::vector<unsigned short> spans);
+    void flush();
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "Watch.hpp"
+#include "File.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+bool Watch::open(FileWatcher &watcher)
+{
+    watcher.fd = -1;
+    watcher.dirs.clear();
+    watcher.files.clear();
+    watcher.lastPoll = std::chrono::steady_clock::now();
+
+#ifdef __linux__
+    // Non blocking, poll once per frame never wait
+    watcher.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watcher.fd < 0)
+    {
+        std::cerr << "[Watch] Error: inotify not available, fall back to polling" << std::endl;
+    }
+#endif
+
+    return true;
+}
+
+void Watch::add(FileWatcher &watcher, std::string_view dir)
+{
+    std::string_view root = File::resolve(dir);
+    if (root.empty())
+    {
+        std::cerr << "[Watch] Error: Directory not found " << dir << std::endl;
+        return;
+    }
+
+    // Watch the directory and every sub directory (inotify is not recursive)
+    std::error_code error;
+    std::vector<std::pair<std::filesystem::path, std::string>> entries = { { std::filesystem::path(root), std::string(dir) } };
+
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(root, error))
+    {
+        std::string name = std::string(dir) + "/" + entry.path().lexically_relative(root).generic_string();
+
+        if (entry.is_directory(error))
+        {
+            entries.emplace_back(entry.path(), name);
+        }
+        else if (entry.is_regular_file(error))
+        {
+            watcher.files.push_back((WatchedFile){ name, entry.path().string(), entry.last_write_time(error) });
+        }
+    }
+
+#ifdef __linux__
+    if (watcher.fd >= 0)
+    {
+        // Close after write or renamed in place (editor save to temp file then rename)
+        for (const auto &[path, name] : entries)
+        {
+            int handle = inotify_add_watch(watcher.fd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+            if (handle >= 0) watcher.dirs.emplace_back(handle, name);
+        }
+        watcher.files.clear();
+    }
+#endif
+}
+
+void Watch::poll(FileWatcher &watcher, std::vector<std::string> &changed)
+{
+    changed.clear();
+
+#ifdef __linux__
+    if (watcher.fd >= 0)
+    {
+        alignas(inotify_event) char buffer[4096];
+
+        while (true)
+        {
+            ssize_t length = read(watcher.fd, buffer, sizeof(buffer));
+            if (length <= 0) break;
+
+            for (char *cursor = buffer; cursor < buffer + length; )
+            {
+                const inotify_event *event = reinterpret_cast<const inotify_event *>(cursor);
+                cursor += sizeof(inotify_event) + event->len;
+
+                if (event->len == 0 || (event->mask & IN_ISDIR)) continue;
+
+                auto dir = std::find_if(watcher.dirs.begin(), watcher.dirs.end(), [event](const auto &watch) { return watch.first == event->wd; });
+                if (dir == watcher.dirs.end()) continue;
+
+                std::string name = dir->second + "/" + event->name;
+
+                // Editor may write many time, report once
+                if (std::find(changed.begin(), changed.end(), name) == changed.end()) changed.push_back(std::move(name));
+            }
+        }
+        return;
+    }
+#endif
+
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<double>(now - watcher.lastPoll).count() < WATCH_POLL_SECONDS) return;
+    watcher.lastPoll = now;
+
+    for (WatchedFile &file : watcher.files)
+    {
+        std::error_code error;
+        std::filesystem::file_time_type mtime = std::filesystem::last_write_time(file.path, error);
+
+        if (!error && mtime != file.mtime)
+        {
+            file.mtime = mtime;
+            changed.push_back(file.name);
+        }
+    }
+}
+
+void Watch::close(FileWatcher &watcher)
+{
+#ifdef __linux__
+    if (watcher.fd >= 0) ::close(watcher.fd);
+#endif
+
+    watcher.fd = -1;
+    watcher.dirs.clear();
+    watcher.files.clear();
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Polling fallback interval when inotify is not available (second)
+#define WATCH_POLL_SECONDS (0.5)
+
+typedef struct WatchedFile
+{
+    // Logical name ("assets/...") and absolute path
+    std::string name;
+    std::string path;
+    std::filesystem::file_time_type mtime;
+} WatchedFile;
+
+typedef struct FileWatcher
+{
+    // inotify descriptor and logical directory of each watch descriptor (Linux)
+    int fd;
+    std::vector<std::pair<int, std::string>> dirs;
+
+    // Other platform: poll file mtime
+    std::vector<WatchedFile> files;
+    std::chrono::steady_clock::time_point lastPoll;
+} FileWatcher;
+
+namespace Watch
+{
+    bool open(FileWatcher &watcher);
+    void add(FileWatcher &watcher, std::string_view dir);
+    void poll(FileWatcher &watcher, std::vector<std::string> &changed);
+    void close(FileWatcher &watcher);
+}
\ No newline at end of file
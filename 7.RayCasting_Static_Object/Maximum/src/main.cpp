@@ -2,8 +2,25 @@
 #include <raymath.h>
 
 #include <array> // Inlude static array STL for tilemap
+#include <vector> // Include dynamic array STL for sprite batch (SoA)
+#include <algorithm> // Include std::sort for sprite depth order
+#include <thread> // Include thread, mutex and atomic for cast scheduler
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono> // Include clock for snapshot throughput
+#include <bitset> // Include bitset for per column coverage mask
+#include <cstring> // Include memcpy for cached pixel copy
+#include <string> // Include string for texture job name
+#include <deque> // Include deque for decoded texture upload queue (FIFO)
+#include <iostream> // Include stream output for map compiler
 
 #include "include/File.hpp" // Include header for function File::getPathFile();
+#include "include/Pack.hpp" // Include header for memory mapped asset pack
+#include "include/TextureCache.hpp" // Include header for decoded texture cache
+#include "include/Map.hpp" // Include header for text and binary map loader
+#include "include/Chunk.hpp" // Include header for chunk streamed huge map
+#include "include/Watch.hpp" // Include header for asset hot reload watcher
 
 // #define RAY_STEP (5)
 #define RAY_STEP (1)
@@ -12,14 +29,78 @@
 #define RAY_LENGTH (1000)
 #define FOV (60 * DEG2RAD)
 #define MAX_DISTANCE (800.0f)
+#define NEAR_PLANE (1.0f)
+
+// Internal render resolution (upscale to window)
+#define RENDER_WIDTH (640)
+#define RENDER_HEIGHT (480)
 
 #define GET_CENTER(POS) CLITERAL(POS / 2.0f)
 #define GET_CENTER_X_TEXT(TEXT, SIZE) CLITERAL(GET_CENTER((GetScreenWidth() - MeasureText(TEXT, SIZE))))
 #define GET_CENTER_Y_TEXT CLITERAL(GET_CENTER(GetScreenHeight()))
 
 #define TILE_SIZE (64)
-#define TILE_WIDTH (15)
-#define TILE_HEIGHT (10)
+// Default level, map size come from the map file at runtime
+#define MAP_FILE "assets/maps/level1.map"
+// Same level with derived data baked offline (build with "make map"), load first when current
+#define MAP_COMPILED_FILE "assets/maps/level1.mapc"
+// Bump when derived data (solid, distance, light) change, old compiled map is rebuilt at load
+#define WORLD_BUILD_VERSION (1)
+// Binary map bigger than this (tile) stream by chunk, with resident chunk memory cap
+#define STREAM_TILES (1024 * 1024)
+#define CHUNK_MEMORY (64 << 20)
+// Prefetch chunk the player may see within this many frame
+#define PREFETCH_FRAMES (60)
+// Player turn speed (radian per frame)
+#define TURN_SPEED (0.05f)
+
+// Tile id of sliding door, its wall texture and open speed (ratio per second)
+#define TILE_DOOR (4)
+#define DOOR_TEXTURE (2)
+#define DOOR_SPEED (1.5f)
+// Generated see-through wall texture
+#define GRATE_TEXTURE (3)
+// Texture loader thread and GPU upload budget per frame (millisecond)
+#define LOADER_THREADS (2)
+#define UPLOAD_BUDGET_MS (2.0)
+
+// Max hit collected per column (partial wall in front + final full wall)
+#define MAX_HITS (4)
+// Number of tile id, see tileInfo
+#define TILE_TYPES (8)
+
+// Baked light: ambient floor, and max light radius (pixel)
+#define LIGHT_AMBIENT (0.2f)
+#define LIGHT_RADIUS_MAX (6 * TILE_SIZE)
+// Dynamic light: max light index per tile bin, floor shade band per column
+#define LIGHT_BIN_MAX (16)
+#define FLOOR_BANDS (16)
+
+// Distance field cap (tile) and max change kept in world change log
+#define DISTANCE_MAX (8)
+#define CHANGE_LOG_MAX (256)
+
+// Split screen local multi-seat
+#define MAX_PLAYERS (4)
+// Column cast worker (include main thread) and column per job
+#define CAST_THREADS (4)
+#define CAST_BATCH (16)
+
+// Server side visibility snapshot benchmark (Press B)
+#define SNAPSHOT_CAMERAS (256)
+#define SNAPSHOT_WIDTH (64)
+#define SNAPSHOT_HEIGHT (48)
+
+// Minimap switch to coarse LOD when one tile is smaller than this (pixel)
+#define MINIMAP_LOD_PIXEL (4.0f)
+
+typedef struct PlayerKeys
+{
+    int forward;
+    int backward;
+    int left;
+    int right;
+} PlayerKeys;
 
 typedef struct Player
 {
@@ -35,16 +116,139 @@ typedef struct Player
     Color mainColor;
     // Player rays color for Render 2D
     Color rayColor;
+
+    // Key binding for local multi-seat
+    PlayerKeys keys;
 } Player;
 
+typedef struct OpaqueSpan
+{
+    // Opaque texel run in one texture column [start, end)
+    unsigned short start;
+    unsigned short end;
+} OpaqueSpan;
+
+typedef struct SpriteTexture
+{
+    Texture texture;
+
+    // Span of column x is spans[columnOffset[x]] until spans[columnOffset[x + 1]]
+    std::vector<int> columnOffset;
+    std::vector<OpaqueSpan> spans;
+} SpriteTexture;
+
+typedef struct TextureJob
+{
+    std::string name;
+    // Slot in wallTex or spriteTex
+    int slot;
+    bool isSprite;
+    // Cut grate hole after decode
+    bool isGrate;
+    // Hot reload: read the loose file even when the pack has it
+    bool fromFile;
+    // Set by queueTexture, only the newest job of a slot is uploaded
+    unsigned int sequence;
+} TextureJob;
+
+typedef struct DecodedTexture
+{
+    TextureJob job;
+    // RGBA8 pixel and span table ready, only GPU upload left
+    Image image;
+    SpriteTexture spriteTex;
+} DecodedTexture;
+
+typedef struct TextureLoader
+{
+    const AssetPack *pack;
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    std::vector<TextureJob> jobs;
+    std::size_t nextJob;
+    // Upload in completion order, result older than the slot newest job is dropped
+    std::deque<DecodedTexture> ready;
+    unsigned int nextSequence;
+    std::vector<unsigned int> wallSequence;
+    std::vector<unsigned int> spriteSequence;
+
+    // Queued and not uploaded yet
+    std::atomic<int> remaining;
+    bool quit;
+
+    // Drawn until real texture is uploaded (opaque checker wall, empty sprite)
+    SpriteTexture wallPlaceholder;
+    SpriteTexture spritePlaceholder;
+} TextureLoader;
+
 typedef struct StaticObject
 {
     Vector2 position;
-    Texture texture;
+    int textureId;
     float scale;
     float radius;
 } StaticStatic;
 
+typedef struct SpriteBatch
+{
+    // Structure of arrays, one entry per static object
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> scale;
+    std::vector<float> radius;
+    std::vector<int> textureId;
+} SpriteBatch;
+
+typedef struct SpriteProjection
+{
+    // Camera space result, same index as SpriteBatch
+    std::vector<float> transformX;
+    std::vector<float> transformY;
+    std::vector<float> screenX;
+    std::vector<float> size;
+
+    // Index of visible sprite, sorted far to near
+    std::vector<int> order;
+} SpriteProjection;
+
+typedef struct RenderView
+{
+    // Viewport rect inside render target
+    float x;
+    float y;
+    int columnCount;
+
+    // Per-frame constant, compute once outside column loop
+    float width;
+    float height;
+    float halfWidth;
+    float halfHeight;
+    float columnWidth;
+    float planeLength;
+} RenderView;
+
+typedef enum UpscaleFilter
+{
+    UPSCALE_NEAREST = 0,
+    UPSCALE_BILINEAR,
+    UPSCALE_SHARP,
+    UPSCALE_COUNT
+} UpscaleFilter;
+
+typedef struct Upscaler
+{
+    // Offscreen target at internal resolution
+    RenderTexture2D target;
+    // Integer prescale target for sharp filter
+    RenderTexture2D sharp;
+    int sharpScale;
+    int filter;
+    int appliedFilter;
+} Upscaler;
+
 typedef struct Render
 {
     Vector2 rayPos;
@@ -60,19 +264,15 @@ typedef struct Render
 
 typedef struct RenderStaticObj
 {
-    float dx;
-    float dy;
-    float angleToObj;
-    float relativeAngle;
-    float distance;
     float correctedDist;
     float size;
     float screenX;
     int rayIndex;
+    int runStart;
     float spriteLeft;
     float spriteRight;
     float columnWidth;
-    float texX;
+    Color tint;
 } RenderStaticObj;
 
 typedef struct RenderTextureMapping
@@ -96,49 +296,515 @@ typedef struct Tilemap
     int hitTile;
 } Tilemap;
 
+typedef struct TileRect
+{
+    // Tile range [left, right) x [top, bottom)
+    int left;
+    int top;
+    int right;
+    int bottom;
+} TileRect;
+
+typedef struct TileChange
+{
+    unsigned int version;
+    TileRect rect;
+} TileChange;
+
+typedef struct Door
+{
+    int x;
+    int y;
+    float target;
+} Door;
+
+typedef enum TileFace
+{
+    // Wall face of a tile, by outward normal
+    FACE_NORTH = 0,
+    FACE_EAST,
+    FACE_SOUTH,
+    FACE_WEST,
+    FACE_COUNT
+} TileFace;
+
+typedef struct StaticLight
+{
+    Vector2 position;
+    float radius;
+    float intensity;
+} StaticLight;
+
+typedef struct DynamicLight
+{
+    Vector2 position;
+    float radius;
+    float intensity;
+    // Intensity lost per second, remove at zero (0 = keep forever)
+    float decay;
+    // Tile range this light is binned in
+    TileRect bin;
+} DynamicLight;
+
+typedef struct LightBin
+{
+    // Fixed capacity, no allocation when light move
+    int count;
+    std::array<unsigned short, LIGHT_BIN_MAX> index;
+    // Light overlapping this tile that did not fit, tile scan every light while > 0
+    int overflow;
+} LightBin;
+
+// Runtime sized 2D storage, row major, grid[y][x] like nested array
+template<typename T>
+struct Grid
+{
+    int width;
+    int height;
+    std::vector<T> cells;
+
+    void resize(int w, int h, const T &value = T())
+    {
+        width = w;
+        height = h;
+        cells.assign(static_cast<std::size_t>(w) * h, value);
+    }
+
+    T *operator[](int y) { return cells.data() + static_cast<std::size_t>(y) * width; }
+    const T *operator[](int y) const { return cells.data() + static_cast<std::size_t>(y) * width; }
+};
+
+typedef struct WorldState
+{
+    // Map size (tile), set once by World::build
+    int width;
+    int height;
+    Grid<unsigned short> tiles;
+
+    // Streamed world: tile come from resident chunk, read-only, no per tile derived data
+    ChunkStream *stream;
+
+    // Bump on every tile or door change
+    unsigned int version;
+    // Change log, a consumer older than firstVersion must rebuild fully
+    std::vector<TileChange> changes;
+    unsigned int firstVersion;
+
+    // ==== Derived Data (update only changed region) ====
+
+    // Solid bitmask, one bit per tile, (width + 63) / 64 word per row
+    Grid<unsigned long long> solid;
+    // Chebyshev distance (tile) to nearest solid, capped to DISTANCE_MAX
+    Grid<unsigned char> distance;
+
+    // Door open ratio [0 close, 1 open] and animation target
+    Grid<float> doorOpen;
+    std::vector<Door> doors;
+
+    // Static light and baked light per tile face (0 - 255), lookup O(1) at shade time
+    std::vector<StaticLight> lights;
+    Grid<std::array<unsigned char, FACE_COUNT>> faceLight;
+    // Baked light at empty tile center, for sprite standing on it
+    Grid<unsigned char> floorLight;
+
+    // Moving light, each tile bin list light whose radius overlap the tile
+    std::vector<DynamicLight> dynamicLights;
+    Grid<LightBin> lightBin;
+} WorldState;
+
+typedef struct TileInfo
+{
+    // Wall texture index and wall height (1 = full tile height)
+    int texture;
+    float height;
+    // Texture has transparent texel, ray continue past this tile
+    bool seeThrough;
+} TileInfo;
+
+typedef struct WallHit
+{
+    // One partial wall hit by the column ray
+    int tile;
+    int mapX;
+    int mapY;
+    bool hitVertical;
+    bool flip;
+    float distance;
+    float hitX;
+} WallHit;
+
+typedef struct ColumnHit
+{
+    // Result of one cast column, enough to draw it again without casting
+    bool hit;
+    int tile;
+    int mapX;
+    int mapY;
+    bool hitVertical;
+    bool flip;
+    float distance;
+    float hitX;
+    // Ray reach a chunk not streamed in yet
+    bool pending;
+
+    // Partial wall in front of the hit, near to far (fixed capacity, no allocation)
+    int layerCount;
+    std::array<WallHit, MAX_HITS - 1> layers;
+} ColumnHit;
+
+typedef struct TemporalStats
+{
+    int cast;
+    int reused;
+    int interpolated;
+    int edgeCast;
+
+    // Relative depth error of interpolated column (only when measureError)
+    float meanDepthError;
+    float maxDepthError;
+} TemporalStats;
+
+typedef struct TemporalColumns
+{
+    // Checkerboard mode: cast only half of column each frame
+    bool enabled;
+    bool measureError;
+
+    bool valid;
+    unsigned int frame;
+    Vector2 lastPosition;
+    float lastAngle;
+    unsigned int worldVersion;
+
+    std::array<ColumnHit, RAY_COUNT> columns;
+    TemporalStats stats;
+} TemporalColumns;
+
+typedef struct Viewport
+{
+    // One split screen player view (own camera, own column range)
+    RenderView view;
+    TemporalColumns temporal;
+    SpriteProjection proj;
+    float depthBuffer[RAY_COUNT];
+    // Visible screen span (top, bottom) of each partial wall, to repaint over sprite
+    std::array<std::array<Vector2, MAX_HITS - 1>, RAY_COUNT> layerSpan;
+    // Row covered by wall per column, floor light go only on open row
+    std::array<std::bitset<RENDER_HEIGHT>, RAY_COUNT> cover;
+} Viewport;
+
+typedef struct CameraState
+{
+    Vector2 position;
+    float angle;
+} CameraState;
+
+typedef struct SnapshotConfig
+{
+    int width;
+    int height;
+    bool withColor;
+
+    // Wall color by tile id (id - 1), used only withColor
+    std::vector<Color> palette;
+} SnapshotConfig;
+
+typedef struct Snapshot
+{
+    // Per column: perpendicular depth and tile id (0 = nothing hit)
+    std::vector<float> depth;
+    std::vector<unsigned char> tileId;
+
+    // Optional width x height RGBA image
+    std::vector<Color> color;
+} Snapshot;
+
+typedef struct SnapshotStats
+{
+    int cameras;
+    int threads;
+    double seconds;
+    double camerasPerSecond;
+} SnapshotStats;
+
+typedef struct CastRequest
+{
+    Vector2 origin;
+    Vector2 dir;
+    Vector2 plane;
+    int column;
+    int columnCount;
+    ColumnHit *out;
+} CastRequest;
+
+typedef struct CastScheduler
+{
+    // Column of every viewport go in one request list, cast by worker pool
+    std::vector<CastRequest> requests;
+    const WorldState *world;
+
+    // Snapshot batch run on the same pool (one task per camera), null when casting column
+    const std::vector<CameraState> *cameras;
+    std::vector<Snapshot> *snapshots;
+    const SnapshotConfig *snapshotConfig;
+
+    // Task of the current batch (column request or camera)
+    int taskCount;
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::atomic<int> next;
+    int remaining;
+    int busy;
+    bool open;
+    bool quit;
+    unsigned int generation;
+} CastScheduler;
+
+typedef enum MinimapRays
+{
+    // Fan from 3D view column, or exact polygon from wall corner
+    MINIMAP_RAYS_FAN = 0,
+    MINIMAP_RAYS_ANALYTIC,
+    MINIMAP_RAYS_COUNT
+} MinimapRays;
+
+typedef struct MinimapCache
+{
+    // Static tile layer, one texel per tile (scaled by TILE_SIZE when drawn)
+    Texture texture;
+    int width;
+    int height;
+    std::vector<Color> pixels;
+
+    // Solid flag pyramid, level k cell = OR of 2^k x 2^k tile (coarse LOD)
+    std::vector<std::vector<unsigned char>> lodSolid;
+
+    // World version baked in, sync by change log
+    unsigned int version;
+    bool valid;
+
+    // Visibility polygon (fan[0] is the player), reused every frame
+    int rayMode;
+    bool outline;
+    std::vector<Vector2> fan;
+    std::vector<float> cornerAngle;
+} MinimapCache;
+
+namespace World
+{
+    void build(WorldState &world, const MapData &map);
+    void buildStream(WorldState &world, ChunkStream &stream);
+    unsigned long long buildKey();
+    bool compile(const char *sourcePath, const char *outputPath);
+    bool loadCompiled(WorldState &world, MapData &map, const CompiledMap &compiled);
+    int reload(WorldState &world, const MapData &map);
+    int tileAt(const WorldState &world, int x, int y);
+    int tileRun(const WorldState &world, int x, int y, int &runLeft, int &runRight);
+    void refresh(WorldState &world, TileRect rect);
+    void logChange(WorldState &world, TileRect rect);
+    void setTile(WorldState &world, int x, int y, int tile);
+    void setDoor(WorldState &world, int x, int y, float target);
+    void updateDoors(WorldState &world, float deltaTime);
+    bool isBlocked(const WorldState &world, int x, int y);
+    int addLight(WorldState &world, StaticLight light);
+    void moveLight(WorldState &world, int index, Vector2 position);
+    void relight(WorldState &world, TileRect rect);
+    TileRect lightRect(const WorldState &world, const StaticLight &light);
+    int faceOf(bool hitVertical, bool flip);
+    int addDynamicLight(WorldState &world, DynamicLight light);
+    void moveDynamicLight(WorldState &world, int index, Vector2 position);
+    void removeDynamicLight(WorldState &world, int index);
+    void updateDynamicLights(WorldState &world, float deltaTime);
+    void binLight(WorldState &world, int index, TileRect rect, bool add);
+    float dynamicLight(const WorldState &world, Vector2 point, Vector2 normal);
+}
+
 namespace Game
 {
     Player control(Player player);
-    Player collision(Player player, Vector2 oldPosPlayer, StaticObject obj, std::array<std::array<int, TILE_WIDTH>, TILE_HEIGHT> worldMap);
+    Player collision(Player player, Vector2 oldPosPlayer, const SpriteBatch &sprites, const WorldState &world);
+    void addStaticObject(SpriteBatch &sprites, StaticObject obj);
+    void prefetchChunks(const ChunkStream &stream, Player player, Vector2 velocity, std::vector<ChunkRequest> &wanted);
+    bool openCachedTexture(const AssetPack &pack, const char *name, bool fromFile, TexCacheView &view, Image &decoded, SpriteTexture &spans);
+    DecodedTexture decodeTexture(const AssetPack &pack, TextureJob job);
+    SpriteTexture loadSpriteTexture(Image image);
+    void startLoader(TextureLoader &loader, const AssetPack &pack, int threadCount);
+    void queueTexture(TextureLoader &loader, TextureJob job);
+    template<std::size_t N>
+    int uploadTextures(TextureLoader &loader, std::array<SpriteTexture, N> &wallTex, std::vector<SpriteTexture> &spriteTex, double budgetMs);
+    void stopLoader(TextureLoader &loader);
+    void buildOpaqueSpans(const Color *pixels, int width, int height, SpriteTexture &spriteTex);
 }
 
 namespace RayCasting
 {
-    Camera2D render2D(Camera2D camera, Player player, Render render, Tilemap map, std::array<std::array<int, TILE_WIDTH>, TILE_HEIGHT> worldMap);
+    Camera2D render2D(Camera2D camera, Player player, Render render, Tilemap map, const WorldState &world, MinimapCache &minimap, const Viewport &viewport);
+    Vector2 castExact(Tilemap map, Vector2 origin, Vector2 rayDir, const WorldState &world);
+    void buildVisibility(MinimapCache &minimap, Player player, Tilemap map, const WorldState &world);
+    void bakeMinimap(MinimapCache &minimap, const WorldState &world);
+    void syncMinimap(MinimapCache &minimap, const WorldState &world);
+    void updateMinimap(MinimapCache &minimap, const WorldState &world, TileRect rect);
+    void unloadMinimap(MinimapCache &minimap);
+    TileRect visibleTiles(Camera2D camera, const WorldState &world);
+    void drawMinimapLod(const MinimapCache &minimap, TileRect rect, float zoom);
+    RenderView makeView(int x, int y, int width, int height, int columnCount);
+    void layoutViewports(std::array<Viewport, MAX_PLAYERS> &viewports, int count, int width, int height);
+    Upscaler loadUpscaler(int width, int height);
+    void present(Upscaler &upscaler);
+    void unloadUpscaler(Upscaler upscaler);
+    void projectSprites(RenderView view, Player player, const SpriteBatch &sprites, SpriteProjection &proj);
+    void drawSpriteRun(RenderView view, const SpriteTexture &sprite, RenderStaticObj renderObj, int firstRay, int lastRay);
+    Vector2 columnRayDir(Vector2 dir, Vector2 plane, int column, int columnCount);
+    ColumnHit castColumn(Render render, Tilemap map, RenderTextureMapping texMap, Vector2 origin, Vector2 dir, Vector2 rayDir, const WorldState &world);
+    bool interpolateColumn(ColumnHit left, ColumnHit right, ColumnHit &out);
+    void startScheduler(CastScheduler &scheduler, int threadCount);
+    void stopScheduler(CastScheduler &scheduler);
+    void scheduleColumns(CastScheduler &scheduler, Viewport &viewport, Player player);
+    void runScheduler(CastScheduler &scheduler, const WorldState &world);
+    void runBatch(CastScheduler &scheduler, const WorldState &world, int taskCount);
+    void drainScheduler(CastScheduler &scheduler);
+    void renderSnapshot(CameraState camera, Snapshot &snapshot, const SnapshotConfig &config, const WorldState &world);
+    SnapshotStats renderSnapshots(const std::vector<CameraState> &cameras, std::vector<Snapshot> &snapshots, const SnapshotConfig &config, const WorldState &world, CastScheduler &scheduler);
+    template<std::size_t N>
+    void drawWallSlice(RenderView view, int column, WallHit wall, Vector2 span, const std::array<SpriteTexture, N> &wallTex, const WorldState &world);
     template<std::size_t N>
-    void render3D(Player player, Render render, RenderStaticObj renderObj, StaticObject staticObj, RenderTextureMapping texMap, Tilemap map, std::array<Texture, N> wallTex, std::array<std::array<int, TILE_WIDTH>, TILE_HEIGHT> worldMap, float depthBuffer[RAY_COUNT]);
+    int composeWall(RenderView view, int column, WallHit wall, Vector2 span, const std::array<SpriteTexture, N> &wallTex, std::bitset<RENDER_HEIGHT> &cover, const WorldState &world);
+    template<std::size_t N>
+    void render3D(Viewport &viewport, Player player, Render render, RenderStaticObj renderObj, const SpriteBatch &sprites, const std::vector<SpriteTexture> &spriteTex, RenderTextureMapping texMap, Tilemap map, const std::array<SpriteTexture, N> &wallTex, const WorldState &world);
 }
 
 // Global variable toggle shade distance view
 bool toggleShadeDistance = false;
-
-int main(void)
+bool toggleLighting = true;
+
+/*
+Tile property by tile id
+[1 - 3] brick wall, [4] door, [5] half wall, [6] low wall, [7] grate
+*/
+const std::array<TileInfo, TILE_TYPES> tileInfo = {{
+    {0, 0.0f, false},
+    {0, 1.0f, false},
+    {1, 1.0f, false},
+    {2, 1.0f, false},
+    {DOOR_TEXTURE, 1.0f, false},
+    {0, 0.5f, false},
+    {2, 0.25f, false},
+    {GRATE_TEXTURE, 1.0f, true}
+}};
+
+int main(int argc, char **argv)
 {
+    // Offline map compiler (make map): bake derived data to a compiled map, no window
+    if (argc == 4 && std::strcmp(argv[1], "--compile-map") == 0) return World::compile(argv[2], argv[3]) ? 0 : 1;
+
+    // Offline map converter (make binmap): text map to binary map (huge map is streamed from it), binary back to text
+    if (argc == 4 && std::strcmp(argv[1], "--convert-map") == 0) return Map::convert(argv[2], argv[3]) ? 0 : 1;
+
     const int WIDTH_SCREEN = 800;
     const int HEIGHT_SCREEN = 600;
 
+    // Window size is free, 3D view always render at RENDER_WIDTH x RENDER_HEIGHT
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
     InitWindow(WIDTH_SCREEN, HEIGHT_SCREEN, "Ray Casting Shading Distance - By Zach Noland");
 
+    // Asset pack (build with "make pack"), missing pack fall back to loose file
+    AssetPack pack = Pack::open(File::getPathFile("assets/assets.pack", false));
+
     /*
     # WORLD MAP - 01
-    Data worldMap id:
+    Load from map file (text or binary, see Map.hpp), tile id:
     [0] floor
     [1] brick_gray
     [2] brick_dark_gray
     [3] brick_dark_blue
+    [4] door (sliding)
+    [5] brick_gray half wall
+    [6] brick_dark_blue low wall
+    [7] grate (see-through)
     */
-    std::array<std::array<int, TILE_WIDTH>, TILE_HEIGHT> worldMap = {{
-        {2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 1, 1, 1, 1, 1},
-        {2, 0, 0, 0, 2, 3, 0, 0, 0, 3, 0, 0, 0, 0, 1},
-        {2, 0, 0, 0, 2, 3, 0, 0, 0, 3, 0, 0, 0, 0, 1},
-        {2, 0, 0, 0, 2, 3, 0, 0, 0, 3, 0, 0, 0, 0, 1},
-        {2, 2, 0, 2, 2, 3, 3, 0, 3, 3, 0, 0, 0, 0, 1},
-        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
-        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
-        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
-        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
-    }};
+    MapData worldMap;
+    WorldState world;
+
+    // Source map: pack entry first, else loose file. Compiled map is checked against this blob, and it is loaded when compiled map is rejected
+    PackBlob mapBlob = Pack::find(pack, MAP_FILE);
+    MappedFile mapFile = (MappedFile){0};
+    long long mapTime = pack.file.mtime;
+
+    if (mapBlob.data == nullptr)
+    {
+        mapFile = Pack::mapFile(File::getPathFile(MAP_FILE, true));
+        mapBlob = (PackBlob){ mapFile.data, mapFile.size };
+        mapTime = mapFile.mtime;
+    }
+
+    // Compiled map first: derived data copied straight in, no build work at startup
+    PackBlob compiledBlob = Pack::find(pack, MAP_COMPILED_FILE);
+    MappedFile compiledFile = (MappedFile){0};
+
+    if (compiledBlob.data == nullptr)
+    {
+        compiledFile = Pack::mapFile(File::getPathFile(MAP_COMPILED_FILE, false));
+        compiledBlob = (PackBlob){ compiledFile.data, compiledFile.size };
+    }
+
+    // Other build parameter or newer source map: build from source map instead
+    CompiledMap compiled;
+    bool isCompiled = Map::readCompiled(compiled, compiledBlob.data, compiledBlob.size, World::buildKey())
+        && Map::isSourceCurrent(*compiled.header, mapBlob, mapTime)
+        && World::loadCompiled(world, worldMap, compiled);
+
+    Pack::unmapFile(compiledFile);
+
+    // Huge binary map stream by chunk from the mapping, other map load fully
+    MapHeader mapHeader;
+    bool isStreamed = !isCompiled && Map::readHeader(mapHeader, mapBlob.data, mapBlob.size) && static_cast<long long>(mapHeader.width) * mapHeader.height > STREAM_TILES;
+
+    ChunkStream stream;
+    bool isMapLoaded = isCompiled;
+    if (!isCompiled)
+    {
+        isMapLoaded = isStreamed
+            ? Chunk::open(stream, worldMap, mapBlob.data, mapBlob.size, CHUNK_MEMORY, TILE_TYPES)
+            : Map::loadFromMemory(worldMap, mapBlob.data, mapBlob.size);
+
+        // Tile id must have a tileInfo entry (compiled map is checked by World::loadCompiled)
+        isMapLoaded = isMapLoaded && std::ranges::all_of(worldMap.tiles, [](unsigned short tile) { return tile < TILE_TYPES; });
+    }
+
+    // Fully loaded map own its tile, mapping not needed anymore
+    if (!isStreamed) Pack::unmapFile(mapFile);
+
+    if (!isMapLoaded)
+    {
+        Pack::unmapFile(mapFile);
+        Pack::close(pack);
+        CloseWindow();
+        return 1;
+    }
+
+    // Runtime world: tile, change log and derived data (compiled map already loaded it)
+    if (isStreamed) World::buildStream(world, stream);
+    else if (!isCompiled) World::build(world, worldMap);
+
+    // No baked light in streamed world
+    if (isStreamed) toggleLighting = false;
+
+    // Moving torch around first map light (else first spawn), rebinned every frame it cross a tile.
+    // Map without light and spawn has no torch
+    float torchAngle = 0.0f;
+    int torch = -1;
+    Vector2 torchAnchor = (Vector2){0};
+
+    if (!worldMap.lights.empty()) torchAnchor = (Vector2){ worldMap.lights[0].x * TILE_SIZE, worldMap.lights[0].y * TILE_SIZE };
+    else if (!worldMap.spawns.empty()) torchAnchor = (Vector2){ (worldMap.spawns[0].x + 0.5f) * TILE_SIZE, (worldMap.spawns[0].y + 0.5f) * TILE_SIZE };
+
+    if (!worldMap.lights.empty() || !worldMap.spawns.empty())
+    {
+        torch = World::addDynamicLight(world, (DynamicLight){ .position = torchAnchor, .radius = 2.5f * TILE_SIZE, .intensity = 0.8f });
+    }
 
     Player player = (Player)
     {
@@ -171,33 +837,127 @@ int main(void)
         .speed = 3.0f,
         .rect = {0.0f, 0.0f, 0.0f, 0.0f},
         .mainColor = BLUE,
-        .rayColor = GREEN
+        .rayColor = GREEN,
+        .keys = {KEY_W, KEY_S, KEY_A, KEY_D}
     };
 
-    
+    // Other seat copy player 1, with own spawn, color and key binding
+    std::array<Player, MAX_PLAYERS> players;
+    // Seat spawn from map, reuse from first when map has fewer
+    std::array<Vector2, MAX_PLAYERS> playerSpawn;
+    for (int i = 0; i < MAX_PLAYERS; ++i)
+    {
+        MapSpawn spawn = worldMap.spawns.empty() ? (MapSpawn){ 1.0f, 1.0f } : worldMap.spawns[i % worldMap.spawns.size()];
+        playerSpawn[i] = (Vector2){ spawn.x, spawn.y };
+    }
+    std::array<PlayerKeys, MAX_PLAYERS> playerKeys = {{
+        {KEY_W, KEY_S, KEY_A, KEY_D},
+        {KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT},
+        {KEY_I, KEY_K, KEY_J, KEY_L},
+        {KEY_KP_8, KEY_KP_5, KEY_KP_4, KEY_KP_6}
+    }};
+    std::array<Color, MAX_PLAYERS> playerColor = {{ BLUE, RED, YELLOW, MAGENTA }};
+
+    // Movement of last frame, for chunk prefetch (scratch list reused every frame)
+    std::array<Vector2, MAX_PLAYERS> playerVelocity = {};
+    std::vector<ChunkRequest> prefetchWanted;
+
+    for (int i = 0; i < MAX_PLAYERS; ++i)
+    {
+        players[i] = player;
+        players[i].spawn = playerSpawn[i];
+        players[i].position = (Vector2)
+        {
+            .x = playerSpawn[i].x * TILE_SIZE + TILE_SIZE / 2.0f,
+            .y = playerSpawn[i].y * TILE_SIZE + TILE_SIZE / 2.0f
+        };
+        players[i].mainColor = playerColor[i];
+        players[i].keys = playerKeys[i];
+    }
+
+
+    // Texture decode on loader thread, slot hold placeholder until upload
+    TextureLoader loader;
+    Game::startLoader(loader, pack, LOADER_THREADS);
+
     // Sparate brickGrayTex texture for save many memory in GPU
-    std::array<Texture, 3> wallTex = {
-        LoadTexture(File::getPathFile("assets/textures/brick/brick_gray.png", false)),
-        LoadTexture(File::getPathFile("assets/textures/brick/brick_darkgray.png", false)),
-        LoadTexture(File::getPathFile("assets/textures/brick/brick_darkblue.png", false))
+    // Wall also keep opaque span table, for see-through tile coverage
+    std::array<SpriteTexture, 4> wallTex;
+    wallTex.fill(loader.wallPlaceholder);
+
+    // Static object texture with opaque span table (build once at load time)
+    std::vector<SpriteTexture> spriteTex(1, loader.spritePlaceholder);
+
+    // Every texture job, kept for hot reload into the same slot
+    const std::vector<TextureJob> textureJobs = {
+        { "assets/textures/brick/brick_gray.png", 0, false, false },
+        { "assets/textures/brick/brick_darkgray.png", 1, false, false },
+        { "assets/textures/brick/brick_darkblue.png", 2, false, false },
+        // Grate: dark gray brick with hole cut out (alpha tested)
+        { "assets/textures/brick/brick_darkgray.png", GRATE_TEXTURE, false, true },
+        { "assets/textures/object/pot_tree.png", 0, true, false }
     };
-    // If you want texture bilinear vibes
-    // for (const auto& wall : wallTex) SetTextureFilter(wall, TEXTURE_FILTER_BILINEAR);
+    for (const TextureJob &job : textureJobs) Game::queueTexture(loader, job);
+    // If you want texture bilinear vibes, set filter after upload
+    // SetTextureFilter(wall.texture, TEXTURE_FILTER_BILINEAR);
+
+    // Hot reload: watch texture and map directory
+    FileWatcher watcher;
+    Watch::open(watcher);
+    Watch::add(watcher, "assets/textures");
+    Watch::add(watcher, "assets/maps");
+    std::vector<std::string> changedFiles;
+
+    // Last hot reload for HUD
+    std::string reloadName;
+    int reloadTiles = 0;
+    double reloadTime = 0.0;
+
+    // All static object live in one SoA batch for camera transform
+    SpriteBatch sprites;
+    for (const MapObject &object : worldMap.objects)
+    {
+        // Unknown sprite texture is skipped
+        if (object.textureId < 0 || object.textureId >= static_cast<int>(spriteTex.size())) continue;
+
+        StaticObject staticObj = (StaticObject)
+        {
+            .position = (Vector2)
+            {
+                static_cast<float>(TILE_SIZE * object.x), 
+                static_cast<float>(TILE_SIZE * object.y)
+            },
+            .textureId = object.textureId,
+            .scale = object.scale,
+            .radius = object.radius
+        };
+
+        Game::addStaticObject(sprites, staticObj);
+    }
+
+    // Split screen viewport, each keep own column result between frame (checkerboard)
+    std::array<Viewport, MAX_PLAYERS> viewports = {};
+    int playerCount = 1;
 
-    Texture treePotTex = LoadTexture(File::getPathFile("assets/textures/object/pot_tree.png", false));
+    // Variable toggle checkerboard and its error metric
+    bool toggleCheckerboard = false;
+    bool toggleMeasureError = false;
 
-    StaticObject treePot = (StaticObject)
+    // Offscreen visibility snapshot for many bot camera
+    SnapshotConfig snapshotConfig = (SnapshotConfig)
     {
-        .position = (Vector2)
-        {
-            static_cast<float>(TILE_SIZE * 3.5f), 
-            static_cast<float>(TILE_SIZE * 5.5f)
-        },
-        .texture = treePotTex,
-        .scale = 90.0f,
-        .radius = 20.0f
+        .width = SNAPSHOT_WIDTH,
+        .height = SNAPSHOT_HEIGHT,
+        .withColor = true,
+        .palette = { LIGHTGRAY, DARKGRAY, DARKBLUE }
     };
-    float depthBuffer[RAY_COUNT];
+    std::vector<CameraState> snapshotCameras;
+    std::vector<Snapshot> snapshots;
+    SnapshotStats snapshotStats = (SnapshotStats){0};
+
+    // One worker pool cast column of all viewport
+    CastScheduler scheduler;
+    RayCasting::startScheduler(scheduler, CAST_THREADS);
 
     Tilemap map;
     Render render;
@@ -207,44 +967,225 @@ int main(void)
     // Variable toggle map view
     bool toggleMap = false;
 
+    // Minimap tile layer, bake on first draw
+    MinimapCache minimap = (MinimapCache){0};
+
+    // Offscreen 3D view and its per-frame constant
+    Upscaler upscaler = RayCasting::loadUpscaler(RENDER_WIDTH, RENDER_HEIGHT);
+    RayCasting::layoutViewports(viewports, playerCount, RENDER_WIDTH, RENDER_HEIGHT);
+
     SetTargetFPS(60);
 
     while (!WindowShouldClose())
     {
-        // Save old position
-        Vector2 oldPosPlayer = player.position;
+        // Upload decoded texture, bounded so loading never spike the frame
+        Game::uploadTextures(loader, wallTex, spriteTex, UPLOAD_BUDGET_MS);
+
+        // Install streamed chunk and evict old one, before any ray is cast this frame
+        if (isStreamed) Chunk::pump(stream);
+
+        // Hot reload: texture into its slot (async, placeholder stay meanwhile), map by tile diff
+        Watch::poll(watcher, changedFiles);
+        for (const std::string &name : changedFiles)
+        {
+            for (TextureJob job : textureJobs)
+            {
+                if (job.name != name) continue;
+
+                job.fromFile = true;
+                Game::queueTexture(loader, job);
+                reloadName = name;
+                reloadTime = GetTime();
+            }
+
+            // Streamed world is read-only
+            if (name != MAP_FILE || isStreamed) continue;
 
-        // Player control
-        player = Game::control(player);
+            MapData reloaded;
+            if (!Map::load(reloaded, File::getPathFile(MAP_FILE, false))) continue;
+            if (!std::ranges::all_of(reloaded.tiles, [](unsigned short tile) { return tile < TILE_TYPES; })) continue;
 
-        // Player collision
-        player = Game::collision(player, oldPosPlayer, treePot, worldMap);
+            reloadName = MAP_FILE;
+            reloadTiles = World::reload(world, reloaded);
+            reloadTime = GetTime();
+        }
+
+        for (int i = 0; i < playerCount; ++i)
+        {
+            // Save old position
+            Vector2 oldPosPlayer = players[i].position;
+
+            // Player control
+            players[i] = Game::control(players[i]);
+
+            // Player collision
+            players[i] = Game::collision(players[i], oldPosPlayer, sprites, world);
+            playerVelocity[i] = Vector2Subtract(players[i].position, oldPosPlayer);
+        }
+
+        // Queue chunk each player will likely see soon, before ray miss them
+        if (isStreamed)
+        {
+            prefetchWanted.clear();
+            for (int i = 0; i < playerCount; ++i) Game::prefetchChunks(stream, players[i], playerVelocity[i], prefetchWanted);
+            Chunk::prefetch(stream, prefetchWanted);
+        }
+
+        // Change player count (Press 1 - 4)
+        for (int i = 0; i < MAX_PLAYERS; ++i)
+        {
+            if (IsKeyPressed(KEY_ONE + i) && playerCount != i + 1)
+            {
+                playerCount = i + 1;
+                RayCasting::layoutViewports(viewports, playerCount, RENDER_WIDTH, RENDER_HEIGHT);
+            }
+        }
 
         // Toggle shade distance (Press N)
         if (IsKeyPressed(KEY_N)) toggleShadeDistance = !toggleShadeDistance;
 
+        // Toggle baked lighting (Press H, L is player 3 turn), move first light to player 1 (Press T)
+        if (IsKeyPressed(KEY_H) && !isStreamed) toggleLighting = !toggleLighting;
+        if (IsKeyPressed(KEY_T) && !isStreamed && !world.lights.empty()) World::moveLight(world, 0, players[0].position);
+
+        // Muzzle flash in front of player 1, fade out fast (Press Space)
+        if (IsKeyPressed(KEY_SPACE))
+        {
+            World::addDynamicLight(world, (DynamicLight)
+            {
+                .position = (Vector2){ players[0].position.x + cosf(players[0].angle) * 20.0f, players[0].position.y + sinf(players[0].angle) * 20.0f },
+                .radius = 3.0f * TILE_SIZE,
+                .intensity = 1.0f,
+                .decay = 6.0f
+            });
+        }
+
+        // Torch walk around its anchor, kept inside the map
+        torchAngle += GetFrameTime();
+        if (torch >= 0)
+        {
+            World::moveDynamicLight(world, torch, (Vector2)
+            {
+                Clamp(torchAnchor.x + cosf(torchAngle) * 4.0f * TILE_SIZE, 0.0f, world.width * TILE_SIZE - 1.0f),
+                Clamp(torchAnchor.y + sinf(torchAngle) * 1.5f * TILE_SIZE, 0.0f, world.height * TILE_SIZE - 1.0f)
+            });
+        }
+        World::updateDynamicLights(world, GetFrameTime());
+
         // Toggle 2d map view (Press M)
         if (IsKeyPressed(KEY_M)) toggleMap = !toggleMap;
 
+        // Cycle 2d map ray mode (Press R), toggle visibility outline (Press O)
+        if (toggleMap && IsKeyPressed(KEY_R)) minimap.rayMode = (minimap.rayMode + 1) % MINIMAP_RAYS_COUNT;
+        if (toggleMap && IsKeyPressed(KEY_O)) minimap.outline = !minimap.outline;
+
+        // Zoom 2d map view (Hold Z / X)
+        if (toggleMap && IsKeyDown(KEY_Z)) players[0].camera.zoom = fmaxf(players[0].camera.zoom * 0.97f, 0.02f);
+        if (toggleMap && IsKeyDown(KEY_X)) players[0].camera.zoom = fminf(players[0].camera.zoom * 1.03f, 4.0f);
+
+        // Toggle checkerboard column rendering (Press C), error metric (Press V)
+        if (IsKeyPressed(KEY_C)) toggleCheckerboard = !toggleCheckerboard;
+        if (IsKeyPressed(KEY_V)) toggleMeasureError = !toggleMeasureError;
+
+        // Render snapshot of random bot camera and measure throughput (Press B)
+        if (IsKeyPressed(KEY_B))
+        {
+            snapshotCameras.clear();
+
+            // Streamed world may have few resident empty tile, give up after enough try
+            for (int attempt = 0; attempt < SNAPSHOT_CAMERAS * 100 && static_cast<int>(snapshotCameras.size()) < SNAPSHOT_CAMERAS; ++attempt)
+            {
+                int tileX = GetRandomValue(0, world.width - 1);
+                int tileY = GetRandomValue(0, world.height - 1);
+                if (World::tileAt(world, tileX, tileY) != 0) continue;
+
+                snapshotCameras.push_back((CameraState)
+                {
+                    .position = (Vector2){ tileX * TILE_SIZE + TILE_SIZE / 2.0f, tileY * TILE_SIZE + TILE_SIZE / 2.0f },
+                    .angle = GetRandomValue(0, 359) * DEG2RAD
+                });
+            }
+
+            snapshotStats = RayCasting::renderSnapshots(snapshotCameras, snapshots, snapshotConfig, world, scheduler);
+        }
+
+        // Cycle upscale filter (Press F)
+        if (IsKeyPressed(KEY_F)) upscaler.filter = (upscaler.filter + 1) % UPSCALE_COUNT;
+
+        // Open / close door in front of player 1 (Press E)
+        if (IsKeyPressed(KEY_E))
+        {
+            int doorX = (players[0].position.x + cosf(players[0].angle) * TILE_SIZE) / TILE_SIZE;
+            int doorY = (players[0].position.y + sinf(players[0].angle) * TILE_SIZE) / TILE_SIZE;
+
+            if (doorX >= 0 && doorY >= 0 && doorX < world.width && doorY < world.height && !isStreamed && world.tiles[doorY][doorX] == TILE_DOOR)
+            {
+                World::setDoor(world, doorX, doorY, world.doorOpen[doorY][doorX] < 0.5f ? 1.0f : 0.0f);
+            }
+        }
+
+        // Destroy wall at center of player 1 view, never the map border (Press G)
+        if (IsKeyPressed(KEY_G))
+        {
+            const ColumnHit &center = viewports[0].temporal.columns[viewports[0].view.columnCount / 2];
+
+            if (center.hit && center.mapX > 0 && center.mapY > 0 && center.mapX < world.width - 1 && center.mapY < world.height - 1)
+            {
+                World::setTile(world, center.mapX, center.mapY, 0);
+            }
+        }
+
+        // Animate door open ratio
+        World::updateDoors(world, GetFrameTime());
+
+        // CAST COLUMN of all viewport in one batch
+        for (int i = 0; i < playerCount; ++i)
+        {
+            viewports[i].temporal.enabled = toggleCheckerboard;
+            viewports[i].temporal.measureError = toggleMeasureError;
+
+            RayCasting::scheduleColumns(scheduler, viewports[i], players[i]);
+        }
+        RayCasting::runScheduler(scheduler, world);
+
+        // DRAW 3D VIEW (internal resolution)
+        BeginTextureMode(upscaler.target);
+        ClearBackground(BLACK);
+
+        for (int i = 0; i < playerCount; ++i)
+        {
+            const RenderView &view = viewports[i].view;
+
+            // Keep wall and sprite inside own viewport
+            BeginScissorMode(static_cast<int>(view.x), static_cast<int>(view.y), static_cast<int>(view.width), static_cast<int>(view.height));
+
+            // Add floor and ceil
+            DrawRectangle(
+                static_cast<int>(view.x), 
+                static_cast<int>(view.y),
+                static_cast<int>(view.width),
+                static_cast<int>(view.halfHeight),
+                DARKGRAY
+            );
+            DrawRectangle(
+                static_cast<int>(view.x), 
+                static_cast<int>(view.y + view.halfHeight),
+                static_cast<int>(view.width),
+                static_cast<int>(view.halfHeight),
+                GRAY
+            );
+
+            RayCasting::render3D(viewports[i], players[i], render, renderObj, sprites, spriteTex, texMap, map, wallTex, world);
+
+            EndScissorMode();
+        }
+        EndTextureMode();
+
         BeginDrawing();
-		// Add floor and ceil
-        DrawRectangle(
-            0, 
-            0,
-            GetScreenWidth(),
-            static_cast<int>(GET_CENTER(GetScreenHeight())),
-            DARKGRAY
-        );
-        DrawRectangle(
-            0, 
-            static_cast<int>(GET_CENTER(GetScreenHeight())),
-            GetScreenWidth(),
-            static_cast<int>(GET_CENTER(GetScreenHeight())),
-            GRAY
-        );
+        ClearBackground(BLACK);
 
-        // DRAW 3D VIEW
-        RayCasting::render3D(player, render, renderObj, treePot, texMap, map, wallTex, worldMap, depthBuffer);
+        // Upscale 3D view to window
+        RayCasting::present(upscaler);
 
         // Logic toggle render
         if (toggleMap) 
@@ -262,7 +1203,7 @@ int main(void)
             );
 
             // DRAW 2D MAP
-            player.camera = RayCasting::render2D(player.camera, player, render, map, worldMap);
+            players[0].camera = RayCasting::render2D(players[0].camera, players[0], render, map, world, minimap, viewports[0]);
 
             // Add title in 2D map menu
             DrawText(
@@ -283,324 +1224,2709 @@ int main(void)
             toggleShadeDistance ? BLUE : RED
         );
 
-        EndDrawing();
-    }
+        // Upscale filter display status
+        DrawText(
+            TextFormat("Upscale %dx%d: %s", RENDER_WIDTH, RENDER_HEIGHT, upscaler.filter == UPSCALE_NEAREST ? "Nearest" : upscaler.filter == UPSCALE_BILINEAR ? "Bilinear" : "Sharp"),
+            5,
+            25,
+            15,
+            WHITE
+        );
 
-    // Unload wall texture
-    for (const auto& tex : wallTex) UnloadTexture(tex);
+        // Checkerboard display status and quality metric (player 1)
+        const TemporalColumns &temporal = viewports[0].temporal;
+        DrawText(
+            temporal.enabled ? TextFormat("Checkerboard: cast %d/%d, reuse %d, interp %d, edge %d, err %.2f%% (max %.2f%%)", temporal.stats.cast, viewports[0].view.columnCount, temporal.stats.reused, temporal.stats.interpolated, temporal.stats.edgeCast, temporal.stats.meanDepthError * 100.0f, temporal.stats.maxDepthError * 100.0f) : "Checkerboard: False",
+            5,
+            45,
+            15,
+            temporal.enabled ? BLUE : RED
+        );
 
-    // Unload static object texture
-    UnloadTexture(treePotTex);
+        // Split screen display status
+        DrawText(
+            TextFormat("Players: %d (cast thread %d)", playerCount, CAST_THREADS),
+            5,
+            65,
+            15,
+            WHITE
+        );
 
-    CloseWindow();
+        // Lighting display status
+        DrawText(
+            TextFormat("Lighting: %s (%d static, %d dynamic)", toggleLighting ? "True" : "False", static_cast<int>(world.lights.size()), static_cast<int>(world.dynamicLights.size())),
+            5,
+            85,
+            15,
+            toggleLighting ? BLUE : RED
+        );
+
+        // Chunk streaming display status
+        if (isStreamed)
+        {
+            DrawText(
+                TextFormat("Chunk: %d/%d resident (%.2f MB RLE, %.1f MB dense), hit %.1f%%, frame %d hit %d miss, %d pending (%d prefetch, %llu prefetched)", stream.stats.resident, stream.stats.capacity, stream.stats.residentBytes / (1024.0f * 1024.0f), stream.stats.denseBytes / (1024.0f * 1024.0f), stream.stats.hitRate * 100.0f, stream.stats.frameHits, stream.stats.frameMisses, stream.stats.pending, stream.stats.prefetchQueued, stream.stats.prefetchLoads),
+                5,
+                145,
+                15,
+                stream.stats.pending > 0 ? YELLOW : WHITE
+            );
+        }
+
+        // Hot reload display status, few second after each reload
+        if (reloadTime > 0.0 && GetTime() - reloadTime < 3.0)
+        {
+            const char *reloadText = TextFormat("Reload: %s", reloadName.c_str());
+            if (reloadName == MAP_FILE)
+            {
+                reloadText = reloadTiles < 0 ? TextFormat("Reload: %s (new size, rebuilt)", reloadName.c_str()) : TextFormat("Reload: %s (%d tile changed)", reloadName.c_str(), reloadTiles);
+            }
+
+            DrawText(
+                reloadText,
+                5,
+                165,
+                15,
+                GREEN
+            );
+        }
+
+        // Texture loading display status
+        if (loader.remaining > 0)
+        {
+            DrawText(
+                TextFormat("Loading texture: %d left", loader.remaining.load()),
+                5,
+                125,
+                15,
+                YELLOW
+            );
+        }
+
+        // Snapshot throughput display status
+        if (snapshotStats.cameras > 0)
+        {
+            DrawText(
+                TextFormat("Snapshot: %d camera %dx%d in %.2f ms (%.0f camera/s, %d thread)", snapshotStats.cameras, SNAPSHOT_WIDTH, SNAPSHOT_HEIGHT, snapshotStats.seconds * 1000.0, snapshotStats.camerasPerSecond, snapshotStats.threads),
+                5,
+                105,
+                15,
+                WHITE
+            );
+        }
+
+        EndDrawing();
+    }
+
+    // Unload wall texture
+    // Join loader first, slot still on placeholder is not unloaded twice
+    Game::stopLoader(loader);
+
+    for (const auto& tex : wallTex) if (tex.texture.id != loader.wallPlaceholder.texture.id) UnloadTexture(tex.texture);
+
+    // Unload static object texture
+    for (const auto& tex : spriteTex) if (tex.texture.id != loader.spritePlaceholder.texture.id) UnloadTexture(tex.texture);
+    UnloadTexture(loader.wallPlaceholder.texture);
+    UnloadTexture(loader.spritePlaceholder.texture);
+
+    // Unload offscreen render target
+    RayCasting::unloadUpscaler(upscaler);
+
+    // Unload minimap tile layer
+    RayCasting::unloadMinimap(minimap);
+
+    Watch::close(watcher);
+
+    // Join chunk loader before the map mapping go away
+    if (isStreamed) Chunk::close(stream);
+    Pack::unmapFile(mapFile);
+
+    // Unmap asset pack, wait background cache writer
+    Pack::close(pack);
+    TextureCache::flush();
+
+    // Join cast worker
+    RayCasting::stopScheduler(scheduler);
+
+    CloseWindow();
     return 0;
 }
 
-Player Game::control(Player player)
+void World::build(WorldState &world, const MapData &map)
+{
+    // Every per tile storage sized once from the map
+    world.width = map.width;
+    world.height = map.height;
+    world.stream = nullptr;
+    world.tiles.resize(map.width, map.height);
+    world.tiles.cells = map.tiles;
+    world.solid.resize((map.width + 63) / 64, map.height, 0);
+    world.distance.resize(map.width, map.height, 0);
+    world.doorOpen.resize(map.width, map.height, 0.0f);
+    world.faceLight.resize(map.width, map.height);
+    world.floorLight.resize(map.width, map.height, 0);
+    world.lightBin.resize(map.width, map.height, (LightBin){});
+
+    world.version = 0;
+    world.firstVersion = 0;
+    world.changes.clear();
+    world.doors.clear();
+    world.lights.clear();
+    world.dynamicLights.clear();
+
+    for (int i = 0; i < world.height; ++i)
+    {
+        for (int j = 0; j < world.width; ++j)
+        {
+            if (world.tiles[i][j] == TILE_DOOR) world.doors.push_back((Door){ j, i, 0.0f });
+        }
+    }
+
+    World::refresh(world, (TileRect){ 0, 0, world.width, world.height });
+    World::relight(world, (TileRect){ 0, 0, world.width, world.height });
+
+    // Static light from the map (map unit is tile)
+    for (const MapLight &light : map.lights)
+    {
+        World::addLight(world, (StaticLight){ (Vector2){ light.x * TILE_SIZE, light.y * TILE_SIZE }, light.radius * TILE_SIZE, light.intensity });
+    }
+}
+
+int World::reload(WorldState &world, const MapData &map)
+{
+    // New size: rebuild all, version keep going so every consumer rebuild fully
+    if (map.width != world.width || map.height != world.height)
+    {
+        unsigned int version = world.version;
+        std::vector<DynamicLight> dynamicLights = world.dynamicLights;
+
+        World::build(world, map);
+        for (const DynamicLight &light : dynamicLights) World::addDynamicLight(world, light);
+
+        world.version = version + 1;
+        world.firstVersion = world.version;
+        return -1;
+    }
+
+    // ==== Tile Diff ====
+    // Changed tile mark its block dirty, derived data is updated once per dirty block
+
+    const int block = 16;
+    const int blocksX = (world.width + block - 1) / block;
+    const int blocksY = (world.height + block - 1) / block;
+    std::vector<unsigned char> dirty(blocksX * blocksY, 0);
+    int dirtyCount = 0;
+    int changed = 0;
+
+    for (int i = 0; i < world.height; ++i)
+    {
+        const unsigned short *row = map.tiles.data() + static_cast<std::size_t>(i) * world.width;
+        if (std::equal(row, row + world.width, world.tiles[i])) continue;
+
+        for (int j = 0; j < world.width; ++j)
+        {
+            if (world.tiles[i][j] == row[j]) continue;
+
+            if (world.tiles[i][j] == TILE_DOOR) std::erase_if(world.doors, [i, j](const Door &door) { return door.x == j && door.y == i; });
+            if (row[j] == TILE_DOOR) world.doors.push_back((Door){ j, i, 0.0f });
+
+            world.tiles[i][j] = row[j];
+            world.doorOpen[i][j] = 0.0f;
+            dirtyCount += !dirty[(i / block) * blocksX + j / block];
+            dirty[(i / block) * blocksX + j / block] = 1;
+            changed++;
+        }
+    }
+
+    // Change all over the map: one whole pass is cheaper than many block with margin
+    if (dirtyCount * 4 > blocksX * blocksY)
+    {
+        TileRect all = (TileRect){ 0, 0, world.width, world.height };
+        World::refresh(world, all);
+        World::logChange(world, all);
+        World::relight(world, all);
+        return changed;
+    }
+
+    std::vector<unsigned char> lightDirty(world.lights.size(), 0);
+
+    for (int by = 0; by < blocksY; ++by)
+    {
+        for (int bx = 0; bx < blocksX; ++bx)
+        {
+            if (!dirty[by * blocksX + bx]) continue;
+
+            TileRect rect = (TileRect){ bx * block, by * block, std::min(world.width, (bx + 1) * block), std::min(world.height, (by + 1) * block) };
+            World::refresh(world, rect);
+            World::logChange(world, rect);
+            World::relight(world, rect);
+
+            for (std::size_t k = 0; k < world.lights.size(); ++k)
+            {
+                TileRect area = World::lightRect(world, world.lights[k]);
+                if (area.left < rect.right && rect.left < area.right && area.top < rect.bottom && rect.top < area.bottom) lightDirty[k] = 1;
+            }
+        }
+    }
+
+    // Occlusion change, each light reaching a dirty block rebake once
+    for (std::size_t k = 0; k < world.lights.size(); ++k)
+    {
+        if (lightDirty[k]) World::relight(world, World::lightRect(world, world.lights[k]));
+    }
+
+    return changed;
+}
+
+void World::buildStream(WorldState &world, ChunkStream &stream)
+{
+    // Only size and tile source, per tile grid would not fit in memory
+    world = (WorldState){};
+    world.width = stream.width;
+    world.height = stream.height;
+    world.stream = &stream;
+}
+
+unsigned long long World::buildKey()
+{
+    // Every parameter derived data depend on, compiled map with other key is built again at load
+    const float param[] = {
+        WORLD_BUILD_VERSION,
+        TILE_SIZE,
+        TILE_TYPES,
+        TILE_DOOR,
+        DISTANCE_MAX,
+        FACE_COUNT,
+        LIGHT_AMBIENT,
+        LIGHT_RADIUS_MAX
+    };
+
+    return Pack::hash(reinterpret_cast<const unsigned char *>(param), sizeof(param));
+}
+
+bool World::compile(const char *sourcePath, const char *outputPath)
+{
+    MapData map;
+    if (!Map::load(map, sourcePath)) return false;
+
+    // Streamed map has no per tile derived data, ship it as binary map
+    if (static_cast<long long>(map.width) * map.height > STREAM_TILES)
+    {
+        std::cerr << "[Map] Error: Map too big to compile (streamed), use binary map" << std::endl;
+        return false;
+    }
+
+    if (!std::ranges::all_of(map.tiles, [](unsigned short tile) { return tile < TILE_TYPES; }))
+    {
+        std::cerr << "[Map] Error: Tile id out of range in " << sourcePath << std::endl;
+        return false;
+    }
+
+    // Same build as runtime load, so compiled and built world is always identical
+    auto start = std::chrono::steady_clock::now();
+
+    WorldState world;
+    World::build(world, map);
+
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<unsigned char> source;
+    Map::encodeBinary(map, source);
+
+    auto blob = [](const auto &cells) { return (PackBlob){ reinterpret_cast<const unsigned char *>(cells.data()), cells.size() * sizeof(cells[0]) }; };
+
+    std::array<PackBlob, MAP_SECTION_COUNT> sections;
+    sections[MAP_SECTION_SOURCE] = blob(source);
+    sections[MAP_SECTION_SOLID] = blob(world.solid.cells);
+    sections[MAP_SECTION_DISTANCE] = blob(world.distance.cells);
+    sections[MAP_SECTION_DOOR] = blob(world.doors);
+    sections[MAP_SECTION_FACE_LIGHT] = blob(world.faceLight.cells);
+    sections[MAP_SECTION_FLOOR_LIGHT] = blob(world.floorLight.cells);
+
+    CompiledHeader header = {};
+    header.buildKey = World::buildKey();
+
+    if (!Map::stampSource(header, sourcePath) || !Map::saveCompiled(outputPath, header, sections))
+    {
+        std::cerr << "[Map] Error: Can not write " << outputPath << std::endl;
+        return false;
+    }
+
+    std::cout << "[Map] Compiled " << sourcePath << " (" << map.width << "x" << map.height << ", " << world.doors.size() << " door, " << world.lights.size() << " light, build " << buildMs << " ms) to " << outputPath << std::endl;
+
+    return true;
+}
+
+bool World::loadCompiled(WorldState &world, MapData &map, const CompiledMap &compiled)
+{
+    const PackBlob &source = compiled.section[MAP_SECTION_SOURCE];
+    if (!Map::loadBinary(map, source.data, source.size, true)) return false;
+
+    // Stale or edited compiled map can hold any tile id, every id must have a tileInfo entry
+    if (!std::ranges::all_of(map.tiles, [](unsigned short tile) { return tile < TILE_TYPES; })) return false;
+
+    // Section size must match the map, else file is damaged
+    auto fits = [&compiled](MapSection section, std::size_t count, std::size_t elementSize) { return compiled.section[section].size == count * elementSize; };
+
+    const std::size_t tileCount = static_cast<std::size_t>(map.width) * map.height;
+    bool isValid = fits(MAP_SECTION_SOLID, static_cast<std::size_t>((map.width + 63) / 64) * map.height, sizeof(unsigned long long))
+        && fits(MAP_SECTION_DISTANCE, tileCount, sizeof(unsigned char))
+        && fits(MAP_SECTION_FACE_LIGHT, tileCount, sizeof(std::array<unsigned char, FACE_COUNT>))
+        && fits(MAP_SECTION_FLOOR_LIGHT, tileCount, sizeof(unsigned char))
+        && compiled.section[MAP_SECTION_DOOR].size % sizeof(Door) == 0;
+
+    if (!isValid) return false;
+
+    // Same storage with World::build, filled by copy only (no refresh, no relight)
+    world = (WorldState){};
+    world.width = map.width;
+    world.height = map.height;
+    world.tiles.resize(map.width, map.height);
+    world.tiles.cells = map.tiles;
+    world.solid.resize((map.width + 63) / 64, map.height);
+    world.distance.resize(map.width, map.height);
+    world.doorOpen.resize(map.width, map.height, 0.0f);
+    world.faceLight.resize(map.width, map.height);
+    world.floorLight.resize(map.width, map.height);
+    world.lightBin.resize(map.width, map.height, (LightBin){});
+    world.doors.resize(compiled.section[MAP_SECTION_DOOR].size / sizeof(Door));
+
+    auto copy = [&compiled](MapSection section, void *cells) { std::memcpy(cells, compiled.section[section].data, compiled.section[section].size); };
+
+    copy(MAP_SECTION_SOLID, world.solid.cells.data());
+    copy(MAP_SECTION_DISTANCE, world.distance.cells.data());
+    copy(MAP_SECTION_DOOR, world.doors.data());
+    copy(MAP_SECTION_FACE_LIGHT, world.faceLight.cells.data());
+    copy(MAP_SECTION_FLOOR_LIGHT, world.floorLight.cells.data());
+
+    // Door index the tile grid, same check as tile id (world left empty for the source map build)
+    if (!std::ranges::all_of(world.doors, [&map](const Door &door) { return door.x >= 0 && door.x < map.width && door.y >= 0 && door.y < map.height; }))
+    {
+        world = (WorldState){};
+        return false;
+    }
+
+    // Light already baked, only keep the list for relight on change
+    for (const MapLight &light : map.lights)
+    {
+        world.lights.push_back((StaticLight){ (Vector2){ light.x * TILE_SIZE, light.y * TILE_SIZE }, fminf(light.radius * TILE_SIZE, LIGHT_RADIUS_MAX), light.intensity });
+    }
+
+    return true;
+}
+
+int World::tileAt(const WorldState &world, int x, int y)
+{
+    // Caller check map bound, streamed tile may be CHUNK_PENDING
+    if (world.stream == nullptr) return world.tiles[y][x];
+
+    return Chunk::tile(*world.stream, x, y);
+}
+
+int World::tileRun(const WorldState &world, int x, int y, int &runLeft, int &runRight)
+{
+    // Same tile in [runLeft, runRight) of row y, full grid world only know the tile itself
+    if (world.stream == nullptr)
+    {
+        runLeft = x;
+        runRight = x + 1;
+        return world.tiles[y][x];
+    }
+
+    return Chunk::tileRun(*world.stream, x, y, runLeft, runRight);
+}
+
+void World::refresh(WorldState &world, TileRect rect)
+{
+    // ==== Solid Bitmask ====
+
+    for (int i = rect.top; i < rect.bottom; ++i)
+    {
+        for (int j = rect.left; j < rect.right; ++j)
+        {
+            if (world.tiles[i][j] > 0) world.solid[i][j >> 6] |= 1ull << (j & 63);
+            else world.solid[i][j >> 6] &= ~(1ull << (j & 63));
+        }
+    }
+
+    // ==== Distance Field ====
+    // Only tile closer than DISTANCE_MAX to the change can get a new value
+
+    TileRect area = (TileRect)
+    {
+        std::max(0, rect.left - DISTANCE_MAX),
+        std::max(0, rect.top - DISTANCE_MAX),
+        std::min(world.width, rect.right + DISTANCE_MAX),
+        std::min(world.height, rect.bottom + DISTANCE_MAX)
+    };
+
+    // Separable Chebyshev: row distance first, then min of max(dy, row) by column
+    int rowTop = std::max(0, area.top - DISTANCE_MAX);
+    int rowBottom = std::min(world.height, area.bottom + DISTANCE_MAX);
+
+    // Row pass scratch only as big as the updated area
+    const int areaWidth = area.right - area.left;
+    std::vector<unsigned char> row(static_cast<std::size_t>(rowBottom - rowTop) * areaWidth);
+    auto isSolid = [&world](int x, int y) { return world.solid[y][x >> 6] >> (x & 63) & 1; };
+
+    for (int i = rowTop; i < rowBottom; ++i)
+    {
+        for (int j = area.left; j < area.right; ++j)
+        {
+            // Outside map count as solid
+            int best = std::min({ j + 1, world.width - j, DISTANCE_MAX });
+
+            for (int k = 0; k < best; ++k)
+            {
+                if ((j - k >= 0 && isSolid(j - k, i)) || (j + k < world.width && isSolid(j + k, i)))
+                {
+                    best = k;
+                    break;
+                }
+            }
+            row[(i - rowTop) * areaWidth + (j - area.left)] = static_cast<unsigned char>(best);
+        }
+    }
+
+    for (int i = area.top; i < area.bottom; ++i)
+    {
+        for (int j = area.left; j < area.right; ++j)
+        {
+            int best = std::min({ i + 1, world.height - i, DISTANCE_MAX });
+
+            for (int k = std::max(rowTop, i - best + 1); k < std::min(rowBottom, i + best); ++k)
+            {
+                best = std::min(best, std::max(std::abs(i - k), static_cast<int>(row[(k - rowTop) * areaWidth + (j - area.left)])));
+            }
+            world.distance[i][j] = static_cast<unsigned char>(best);
+        }
+    }
+}
+
+void World::logChange(WorldState &world, TileRect rect)
+{
+    world.version++;
+    world.changes.push_back((TileChange){ world.version, rect });
+
+    // Drop oldest, consumer behind firstVersion rebuild fully
+    if (world.changes.size() > CHANGE_LOG_MAX)
+    {
+        world.changes.erase(world.changes.begin(), world.changes.begin() + (world.changes.size() - CHANGE_LOG_MAX));
+        world.firstVersion = world.changes.front().version - 1;
+    }
+}
+
+void World::setTile(WorldState &world, int x, int y, int tile)
+{
+    // Streamed world is read-only
+    if (world.stream != nullptr || world.tiles[y][x] == tile) return;
+
+    world.tiles[y][x] = tile;
+    world.doorOpen[y][x] = 0.0f;
+
+    std::erase_if(world.doors, [x, y](const Door &door) { return door.x == x && door.y == y; });
+    if (tile == TILE_DOOR) world.doors.push_back((Door){ x, y, 0.0f });
+
+    TileRect rect = (TileRect){ x, y, x + 1, y + 1 };
+    World::refresh(world, rect);
+    World::logChange(world, rect);
+
+    // Occlusion change only inside light that reach this tile
+    World::relight(world, rect);
+    for (const StaticLight &light : world.lights)
+    {
+        TileRect area = World::lightRect(world, light);
+        if (area.left < rect.right && rect.left < area.right && area.top < rect.bottom && rect.top < area.bottom) World::relight(world, area);
+    }
+}
+
+void World::setDoor(WorldState &world, int x, int y, float target)
+{
+    for (Door &door : world.doors)
+    {
+        if (door.x == x && door.y == y) door.target = Clamp(target, 0.0f, 1.0f);
+    }
+}
+
+void World::updateDoors(WorldState &world, float deltaTime)
+{
+    for (const Door &door : world.doors)
+    {
+        float &open = world.doorOpen[door.y][door.x];
+        if (open == door.target) continue;
+
+        bool wasBlocked = World::isBlocked(world, door.x, door.y);
+        open = (open < door.target) ? fminf(open + DOOR_SPEED * deltaTime, door.target) : fmaxf(open - DOOR_SPEED * deltaTime, door.target);
+
+        // Door still solid for distance field, only log change for minimap
+        TileRect rect = (TileRect){ door.x, door.y, door.x + 1, door.y + 1 };
+        World::logChange(world, rect);
+
+        // Light pass the door only when open, relight when it flip
+        if (wasBlocked == World::isBlocked(world, door.x, door.y)) continue;
+
+        for (const StaticLight &light : world.lights)
+        {
+            TileRect area = World::lightRect(world, light);
+            if (area.left < rect.right && rect.left < area.right && area.top < rect.bottom && rect.top < area.bottom) World::relight(world, area);
+        }
+    }
+}
+
+bool World::isBlocked(const WorldState &world, int x, int y)
+{
+    if (x < 0 || y < 0 || x >= world.width || y >= world.height) return true;
+
+    int tile = World::tileAt(world, x, y);
+
+    // Door is passable when almost open (streamed world has no door state, stay closed)
+    if (tile == TILE_DOOR && world.stream == nullptr) return world.doorOpen[y][x] < 0.9f;
+
+    // Pending chunk block too
+    return tile != 0;
+}
+
+int World::addLight(WorldState &world, StaticLight light)
+{
+    light.radius = fminf(light.radius, LIGHT_RADIUS_MAX);
+    world.lights.push_back(light);
+    World::relight(world, World::lightRect(world, light));
+
+    return static_cast<int>(world.lights.size()) - 1;
+}
+
+void World::moveLight(WorldState &world, int index, Vector2 position)
+{
+    // Rebake only old and new light area
+    TileRect before = World::lightRect(world, world.lights[index]);
+    world.lights[index].position = position;
+
+    World::relight(world, before);
+    World::relight(world, World::lightRect(world, world.lights[index]));
+}
+
+TileRect World::lightRect(const WorldState &world, const StaticLight &light)
+{
+    // Tile range touched by light radius (include the tile of face on the edge)
+    return (TileRect)
+    {
+        std::max(0, static_cast<int>((light.position.x - light.radius) / TILE_SIZE) - 1),
+        std::max(0, static_cast<int>((light.position.y - light.radius) / TILE_SIZE) - 1),
+        std::min(world.width, static_cast<int>((light.position.x + light.radius) / TILE_SIZE) + 2),
+        std::min(world.height, static_cast<int>((light.position.y + light.radius) / TILE_SIZE) + 2)
+    };
+}
+
+void World::relight(WorldState &world, TileRect rect)
+{
+    // Streamed world has no lightmap
+    if (world.stream != nullptr) return;
+
+    // Face center and outward normal, by TileFace
+    const std::array<Vector2, FACE_COUNT> faceOffset = {{ {0.5f, 0.0f}, {1.0f, 0.5f}, {0.5f, 1.0f}, {0.0f, 0.5f} }};
+    const std::array<Vector2, FACE_COUNT> faceNormal = {{ {0.0f, -1.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}, {-1.0f, 0.0f} }};
+
+    for (int i = rect.top; i < rect.bottom; ++i)
+    {
+        for (int j = rect.left; j < rect.right; ++j)
+        {
+            for (int face = 0; face < FACE_COUNT; ++face)
+            {
+                float light = LIGHT_AMBIENT;
+
+                // Empty tile has no wall face to light
+                if (world.tiles[i][j] > 0)
+                {
+                    Vector2 point = (Vector2){ (j + faceOffset[face].x) * TILE_SIZE, (i + faceOffset[face].y) * TILE_SIZE };
+
+                    for (const StaticLight &source : world.lights)
+                    {
+                        Vector2 toLight = Vector2Subtract(source.position, point);
+                        float distance = Vector2Length(toLight);
+                        if (distance >= source.radius || distance < 0.001f) continue;
+
+                        float facing = Vector2DotProduct(faceNormal[face], toLight) / distance;
+                        if (facing <= 0.0f) continue;
+
+                        // Shadow: wall between light and face stop the ray before the face
+                        Vector2 dir = Vector2Scale(toLight, -1.0f / distance);
+                        Vector2 hit = RayCasting::castExact((Tilemap){0}, source.position, dir, world);
+                        if (Vector2Distance(hit, source.position) < distance - 1.0f) continue;
+
+                        light += source.intensity * (1.0f - distance / source.radius) * facing;
+                    }
+                }
+
+                world.faceLight[i][j][face] = static_cast<unsigned char>(255 * Clamp(light, 0.0f, 1.0f));
+            }
+
+            // ==== Floor Light (tile center, no facing) ====
+
+            float light = LIGHT_AMBIENT;
+
+            if (world.tiles[i][j] == 0)
+            {
+                Vector2 point = (Vector2){ (j + 0.5f) * TILE_SIZE, (i + 0.5f) * TILE_SIZE };
+
+                for (const StaticLight &source : world.lights)
+                {
+                    float distance = Vector2Distance(source.position, point);
+                    if (distance >= source.radius) continue;
+
+                    if (distance > 1.0f)
+                    {
+                        Vector2 dir = Vector2Scale(Vector2Subtract(point, source.position), 1.0f / distance);
+                        Vector2 hit = RayCasting::castExact((Tilemap){0}, source.position, dir, world);
+                        if (Vector2Distance(hit, source.position) < distance) continue;
+                    }
+
+                    light += source.intensity * (1.0f - distance / source.radius);
+                }
+            }
+
+            world.floorLight[i][j] = static_cast<unsigned char>(255 * Clamp(light, 0.0f, 1.0f));
+        }
+    }
+}
+
+int World::addDynamicLight(WorldState &world, DynamicLight light)
+{
+    light.radius = fminf(light.radius, LIGHT_RADIUS_MAX);
+    light.bin = World::lightRect(world, (StaticLight){ light.position, light.radius, light.intensity });
+    world.dynamicLights.push_back(light);
+
+    int index = static_cast<int>(world.dynamicLights.size()) - 1;
+    World::binLight(world, index, light.bin, true);
+
+    return index;
+}
+
+void World::moveDynamicLight(WorldState &world, int index, Vector2 position)
+{
+    DynamicLight &light = world.dynamicLights[index];
+    light.position = position;
+
+    TileRect before = light.bin;
+    TileRect after = World::lightRect(world, (StaticLight){ light.position, light.radius, light.intensity });
+
+    // Same tile range, bin not change
+    if (before.left == after.left && before.top == after.top && before.right == after.right && before.bottom == after.bottom) return;
+
+    // Remove from tile it leave, add to tile it enter, overlap untouched
+    for (int i = before.top; i < before.bottom; ++i)
+    {
+        for (int j = before.left; j < before.right; ++j)
+        {
+            if (j >= after.left && j < after.right && i >= after.top && i < after.bottom) continue;
+            World::binLight(world, index, (TileRect){ j, i, j + 1, i + 1 }, false);
+        }
+    }
+    for (int i = after.top; i < after.bottom; ++i)
+    {
+        for (int j = after.left; j < after.right; ++j)
+        {
+            if (j >= before.left && j < before.right && i >= before.top && i < before.bottom) continue;
+            World::binLight(world, index, (TileRect){ j, i, j + 1, i + 1 }, true);
+        }
+    }
+
+    light.bin = after;
+}
+
+void World::removeDynamicLight(WorldState &world, int index)
+{
+    int last = static_cast<int>(world.dynamicLights.size()) - 1;
+
+    // Swap with last light, last light is rebinned with new index
+    World::binLight(world, index, world.dynamicLights[index].bin, false);
+    if (index != last)
+    {
+        World::binLight(world, last, world.dynamicLights[last].bin, false);
+        world.dynamicLights[index] = world.dynamicLights[last];
+        World::binLight(world, index, world.dynamicLights[index].bin, true);
+    }
+
+    world.dynamicLights.pop_back();
+}
+
+void World::updateDynamicLights(WorldState &world, float deltaTime)
+{
+    for (int i = static_cast<int>(world.dynamicLights.size()) - 1; i >= 0; --i)
+    {
+        DynamicLight &light = world.dynamicLights[i];
+        if (light.decay <= 0.0f) continue;
+
+        light.intensity -= light.decay * deltaTime;
+        if (light.intensity <= 0.0f) World::removeDynamicLight(world, i);
+    }
+}
+
+void World::binLight(WorldState &world, int index, TileRect rect, bool add)
+{
+    if (world.stream != nullptr) return;
+
+    for (int i = rect.top; i < rect.bottom; ++i)
+    {
+        for (int j = rect.left; j < rect.right; ++j)
+        {
+            LightBin &bin = world.lightBin[i][j];
+
+            if (add)
+            {
+                // Full bin only count the light, shading fall back to scan all light here
+                if (bin.count < LIGHT_BIN_MAX) bin.index[bin.count++] = static_cast<unsigned short>(index);
+                else bin.overflow++;
+                continue;
+            }
+
+            bool isFound = false;
+            for (int k = 0; k < bin.count; ++k)
+            {
+                if (bin.index[k] != index) continue;
+
+                bin.index[k] = bin.index[--bin.count];
+                isFound = true;
+                break;
+            }
+
+            // Not in the list: it was one of the overflow light
+            if (!isFound && bin.overflow > 0) bin.overflow--;
+        }
+    }
+}
+
+float World::dynamicLight(const WorldState &world, Vector2 point, Vector2 normal)
+{
+    int x = static_cast<int>(point.x / TILE_SIZE);
+    int y = static_cast<int>(point.y / TILE_SIZE);
+    if (world.stream != nullptr || x < 0 || y < 0 || x >= world.width || y >= world.height) return 0.0f;
+
+    // Only light binned to this tile (every light when bin overflow), no shadow for dynamic light
+    const LightBin &bin = world.lightBin[y][x];
+    const bool isOverflow = bin.overflow > 0;
+    const int count = isOverflow ? static_cast<int>(world.dynamicLights.size()) : bin.count;
+    float light = 0.0f;
+
+    for (int k = 0; k < count; ++k)
+    {
+        const DynamicLight &source = world.dynamicLights[isOverflow ? k : bin.index[k]];
+
+        Vector2 toLight = Vector2Subtract(source.position, point);
+        float distance = Vector2Length(toLight);
+        if (distance >= source.radius) continue;
+
+        // Zero normal (floor, sprite) receive light from every side
+        float facing = 1.0f;
+        if (normal.x != 0.0f || normal.y != 0.0f) facing = (distance > 0.001f) ? Vector2DotProduct(normal, toLight) / distance : 1.0f;
+        if (facing <= 0.0f) continue;
+
+        light += source.intensity * (1.0f - distance / source.radius) * facing;
+    }
+
+    return light;
+}
+
+int World::faceOf(bool hitVertical, bool flip)
+{
+    // Flip already tell which side the ray come from
+    if (hitVertical) return flip ? FACE_WEST : FACE_EAST;
+    return flip ? FACE_SOUTH : FACE_NORTH;
+}
+
+Player Game::control(Player player)
+{
+    // Rotate player
+    if (IsKeyDown(player.keys.left)) player.angle -= TURN_SPEED;
+    if (IsKeyDown(player.keys.right)) player.angle += TURN_SPEED;
+
+    // Move player
+    if (IsKeyDown(player.keys.forward))
+    {
+        player.position.x += cosf(player.angle) * player.speed;
+        player.position.y += sinf(player.angle) * player.speed;
+    }
+    if (IsKeyDown(player.keys.backward))
+    {
+        player.position.x -= cosf(player.angle) * player.speed;
+        player.position.y -= sinf(player.angle) * player.speed;
+    }
+    return player;
+}
+
+Player Game::collision(Player player, Vector2 oldPosPlayer, const SpriteBatch &sprites, const WorldState &world)
+{
+    // ==== WorldMap Collision ====
+
+    int left   = (player.position.x - player.radius) / TILE_SIZE;
+    int right  = (player.position.x + player.radius) / TILE_SIZE;
+    int top    = (player.position.y - player.radius) / TILE_SIZE;
+    int bottom = (player.position.y + player.radius) / TILE_SIZE;
+
+    if (left < 0 || right >= world.width || top < 0 || bottom >= world.height)
+    {
+        player.position = oldPosPlayer;
+        return player;
+    }
+
+    if (World::isBlocked(world, left, top) || World::isBlocked(world, right, top) || World::isBlocked(world, left, bottom) || World::isBlocked(world, right, bottom))
+    {
+        player.position = oldPosPlayer;
+    }
+
+    // ==== Static Object Collision ====
+
+    for (std::size_t i = 0; i < sprites.posX.size(); ++i)
+    {
+        float dx = player.position.x - sprites.posX[i];
+        float dy = player.position.y - sprites.posY[i];
+
+        // Compare squared distance, no need sqrtf
+        float minDist = player.radius + sprites.radius[i];
+
+        if (dx * dx + dy * dy < minDist * minDist)
+        {
+            player.position = oldPosPlayer;
+            break;
+        }
+    }
+
+    return player;
+}
+
+void Game::addStaticObject(SpriteBatch &sprites, StaticObject obj)
+{
+    sprites.posX.push_back(obj.position.x);
+    sprites.posY.push_back(obj.position.y);
+    sprites.scale.push_back(obj.scale);
+    sprites.radius.push_back(obj.radius);
+    sprites.textureId.push_back(obj.textureId);
+}
+
+void Game::prefetchChunks(const ChunkStream &stream, Player player, Vector2 velocity, std::vector<ChunkRequest> &wanted)
+{
+    // Farthest a chunk can be and still get in view within PREFETCH_FRAMES
+    const float reach = RAY_LENGTH + player.speed * PREFETCH_FRAMES;
+    const float chunkWorld = CHUNK_SIZE * TILE_SIZE;
+
+    // Walking: closing speed follow real movement, standing: assume walk forward
+    float moving = Vector2Length(velocity);
+    Vector2 moveDir = (moving > 0.01f) ? Vector2Scale(velocity, 1.0f / moving) : (Vector2){ cosf(player.angle), sinf(player.angle) };
+    float speed = fmaxf(moving, player.speed);
+
+    int left = std::max(0, static_cast<int>((player.position.x - reach) / chunkWorld));
+    int top = std::max(0, static_cast<int>((player.position.y - reach) / chunkWorld));
+    int right = std::min(stream.chunksX - 1, static_cast<int>((player.position.x + reach) / chunkWorld));
+    int bottom = std::min(stream.chunksY - 1, static_cast<int>((player.position.y + reach) / chunkWorld));
+
+    for (int cy = top; cy <= bottom; ++cy)
+    {
+        for (int cx = left; cx <= right; ++cx)
+        {
+            // Nearest point of the chunk, zero when player stand in it
+            Vector2 nearest = (Vector2)
+            {
+                Clamp(player.position.x, cx * chunkWorld, (cx + 1) * chunkWorld),
+                Clamp(player.position.y, cy * chunkWorld, (cy + 1) * chunkWorld)
+            };
+            Vector2 toChunk = Vector2Subtract(nearest, player.position);
+            float distance = Vector2Length(toChunk);
+
+            float frames = 0.0f;
+
+            if (distance > 0.0f)
+            {
+                Vector2 toDir = Vector2Scale(toChunk, 1.0f / distance);
+
+                // Frame to come within view distance, chunk behind the motion close slower
+                float closing = speed * fmaxf(Vector2DotProduct(moveDir, toDir), 0.25f);
+                float moveFrames = fmaxf(distance - RAY_LENGTH, 0.0f) / closing;
+
+                // Frame to turn the chunk inside the FOV (chunk center, widened by its angular size)
+                Vector2 center = (Vector2){ (cx + 0.5f) * chunkWorld, (cy + 0.5f) * chunkWorld };
+                float centerDistance = Vector2Distance(center, player.position);
+                float angle = atan2f(center.y - player.position.y, center.x - player.position.x) - player.angle;
+                angle = fabsf(atan2f(sinf(angle), cosf(angle)));
+                float halfSize = asinf(fminf(chunkWorld * 0.7071f / fmaxf(centerDistance, 1.0f), 1.0f));
+                float turnFrames = fmaxf(angle - FOV / 2.0f - halfSize, 0.0f) / TURN_SPEED;
+
+                frames = fmaxf(moveFrames, turnFrames);
+            }
+
+            if (frames > PREFETCH_FRAMES) continue;
+
+            // Time to visible first, nearer first on tie
+            wanted.push_back((ChunkRequest){ cy * stream.chunksX + cx, frames + distance / RAY_LENGTH });
+        }
+    }
+}
+
+bool Game::openCachedTexture(const AssetPack &pack, const char *name, bool fromFile, TexCacheView &view, Image &decoded, SpriteTexture &spans)
+{
+    decoded = (Image){0};
+
+    // ==== Source Identity (size and mtime, no read) ====
+
+    MappedFile source = (MappedFile){0};
+    PackBlob blob = fromFile ? (PackBlob){} : Pack::find(pack, name);
+    SourceKey key = (SourceKey){0};
+
+    if (blob.data != nullptr)
+    {
+        key = (SourceKey){ blob.size, pack.file.mtime, 0 };
+    }
+    else
+    {
+        // Loose file is mapped too, page is read only when decode or hash
+        source = Pack::mapFile(File::getPathFile(name, false));
+        blob = (PackBlob){ source.data, source.size };
+        key = (SourceKey){ source.size, source.mtime, 0 };
+    }
+
+    if (TextureCache::open(view, name, key))
+    {
+        Pack::unmapFile(source);
+        return true;
+    }
+
+    if (blob.data == nullptr) return false;
+
+    // Mtime change: same content hash still use the cache, refresh key in background
+    key.hash = Pack::hash(blob.data, blob.size);
+
+    if (TextureCache::open(view, name, key))
+    {
+        const TexCacheHeader &header = *view.header;
+        TextureCache::store(
+            name, key, header.width, header.height,
+            std::vector<unsigned char>(view.pixels, view.pixels + 4ull * header.width * header.height),
+            std::vector<int>(view.columnOffset, view.columnOffset + header.width + 1),
+            std::vector<unsigned short>(view.spans, view.spans + 2ull * header.spanCount)
+        );
+
+        Pack::unmapFile(source);
+        return true;
+    }
+
+    // ==== Stale: Decode Now, Regenerate Cache in Background ====
+
+    decoded = LoadImageFromMemory(GetFileExtension(name), blob.data, static_cast<int>(blob.size));
+    Pack::unmapFile(source);
+
+    // Broken source image: nothing to upload, nothing to cache
+    if (decoded.data == nullptr) return false;
+
+    ImageFormat(&decoded, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    const Color *pixels = static_cast<const Color *>(decoded.data);
+    Game::buildOpaqueSpans(pixels, decoded.width, decoded.height, spans);
+
+    std::vector<unsigned short> spanPairs;
+    spanPairs.reserve(spans.spans.size() * 2);
+    for (const OpaqueSpan &span : spans.spans)
+    {
+        spanPairs.push_back(span.start);
+        spanPairs.push_back(span.end);
+    }
+
+    const unsigned char *bytes = static_cast<const unsigned char *>(decoded.data);
+    TextureCache::store(name, key, decoded.width, decoded.height, std::vector<unsigned char>(bytes, bytes + 4ull * decoded.width * decoded.height), spans.columnOffset, std::move(spanPairs));
+
+    return false;
+}
+
+DecodedTexture Game::decodeTexture(const AssetPack &pack, TextureJob job)
+{
+    // CPU only (no GL call), safe on loader thread
+    DecodedTexture result;
+    result.job = job;
+
+    TexCacheView view;
+
+    if (Game::openCachedTexture(pack, job.name.c_str(), job.fromFile, view, result.image, result.spriteTex))
+    {
+        // Own copy of cached pixel, mapping is closed before upload
+        const TexCacheHeader &header = *view.header;
+        std::size_t size = 4ull * header.width * header.height;
+
+        result.image = (Image)
+        {
+            .data = MemAlloc(static_cast<unsigned int>(size)),
+            .width = header.width,
+            .height = header.height,
+            .mipmaps = 1,
+            .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+        };
+        std::memcpy(result.image.data, view.pixels, size);
+
+        // Span table already built
+        result.spriteTex.columnOffset.assign(view.columnOffset, view.columnOffset + header.width + 1);
+        result.spriteTex.spans.resize(header.spanCount);
+        for (unsigned int i = 0; i < header.spanCount; ++i)
+        {
+            result.spriteTex.spans[i] = (OpaqueSpan){ view.spans[i * 2], view.spans[i * 2 + 1] };
+        }
+
+        TextureCache::close(view);
+    }
+
+    if (job.isGrate && result.image.data != nullptr)
+    {
+        Image &grate = result.image;
+        for (int y = grate.height / 8; y < grate.height - grate.height / 8; y += grate.height / 4)
+        {
+            for (int x = grate.width / 8; x < grate.width - grate.width / 8; x += grate.width / 4)
+            {
+                ImageDrawRectangle(&grate, x, y, grate.width / 8, grate.height / 8, BLANK);
+            }
+        }
+
+        // Hole change the opaque span
+        Game::buildOpaqueSpans(static_cast<const Color *>(grate.data), grate.width, grate.height, result.spriteTex);
+    }
+
+    return result;
+}
+
+void Game::startLoader(TextureLoader &loader, const AssetPack &pack, int threadCount)
+{
+    loader.pack = &pack;
+    loader.nextJob = 0;
+    loader.nextSequence = 0;
+    loader.remaining = 0;
+    loader.quit = false;
+
+    // ==== Placeholder ====
+
+    Image checker = GenImageColor(8, 8, GRAY);
+    ImageDrawRectangle(&checker, 0, 0, 4, 4, DARKGRAY);
+    ImageDrawRectangle(&checker, 4, 4, 4, 4, DARKGRAY);
+    loader.wallPlaceholder = Game::loadSpriteTexture(checker);
+    UnloadImage(checker);
+
+    Image empty = GenImageColor(1, 1, BLANK);
+    loader.spritePlaceholder = Game::loadSpriteTexture(empty);
+    UnloadImage(empty);
+
+    for (int i = 0; i < threadCount; ++i)
+    {
+        loader.workers.emplace_back([&loader]()
+        {
+            while (true)
+            {
+                TextureJob job;
+                {
+                    std::unique_lock<std::mutex> lock(loader.mutex);
+                    loader.wake.wait(lock, [&loader]() { return loader.quit || loader.nextJob < loader.jobs.size(); });
+                    if (loader.quit) return;
+
+                    job = loader.jobs[loader.nextJob++];
+                }
+
+                // File read and decode outside the lock
+                DecodedTexture result = Game::decodeTexture(*loader.pack, job);
+
+                std::lock_guard<std::mutex> lock(loader.mutex);
+                loader.ready.push_back(std::move(result));
+            }
+        });
+    }
+}
+
+void Game::queueTexture(TextureLoader &loader, TextureJob job)
+{
+    {
+        std::lock_guard<std::mutex> lock(loader.mutex);
+
+        // Newer job of the same slot (hot reload saved twice) win over any older one still decoding
+        std::vector<unsigned int> &latest = job.isSprite ? loader.spriteSequence : loader.wallSequence;
+        if (latest.size() <= static_cast<std::size_t>(job.slot)) latest.resize(job.slot + 1, 0);
+
+        job.sequence = ++loader.nextSequence;
+        latest[job.slot] = job.sequence;
+        loader.jobs.push_back(job);
+    }
+    loader.remaining++;
+    loader.wake.notify_one();
+}
+
+template<std::size_t N>
+int Game::uploadTextures(TextureLoader &loader, std::array<SpriteTexture, N> &wallTex, std::vector<SpriteTexture> &spriteTex, double budgetMs)
+{
+    // Main thread only (GL context), stop when frame budget is used
+    auto start = std::chrono::steady_clock::now();
+    int uploaded = 0;
+
+    while (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() < budgetMs)
+    {
+        DecodedTexture result;
+        bool isStale = false;
+        {
+            std::lock_guard<std::mutex> lock(loader.mutex);
+            if (loader.ready.empty()) break;
+
+            result = std::move(loader.ready.front());
+            loader.ready.pop_front();
+
+            const std::vector<unsigned int> &latest = result.job.isSprite ? loader.spriteSequence : loader.wallSequence;
+            isStale = latest[result.job.slot] != result.job.sequence;
+        }
+
+        SpriteTexture &slot = result.job.isSprite ? spriteTex[result.job.slot] : wallTex[result.job.slot];
+
+        // Decode fail keep the placeholder, stale decode never overwrite a newer one
+        if (result.image.data != nullptr && !isStale)
+        {
+            // Hot reload replace a real texture, free the old one
+            if (slot.texture.id != loader.wallPlaceholder.texture.id && slot.texture.id != loader.spritePlaceholder.texture.id) UnloadTexture(slot.texture);
+
+            result.spriteTex.texture = LoadTextureFromImage(result.image);
+            slot = std::move(result.spriteTex);
+        }
+
+        UnloadImage(result.image);
+        loader.remaining--;
+        uploaded++;
+    }
+
+    return uploaded;
+}
+
+void Game::stopLoader(TextureLoader &loader)
+{
+    {
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        loader.quit = true;
+    }
+    loader.wake.notify_all();
+
+    for (std::thread &worker : loader.workers) worker.join();
+    loader.workers.clear();
+
+    // Decoded but never uploaded
+    for (DecodedTexture &result : loader.ready) UnloadImage(result.image);
+    loader.ready.clear();
+}
+
+SpriteTexture Game::loadSpriteTexture(Image image)
+{
+    SpriteTexture spriteTex;
+
+    Color *pixels = LoadImageColors(image);
+    Game::buildOpaqueSpans(pixels, image.width, image.height, spriteTex);
+    UnloadImageColors(pixels);
+
+    spriteTex.texture = LoadTextureFromImage(image);
+
+    return spriteTex;
+}
+
+void Game::buildOpaqueSpans(const Color *pixels, int width, int height, SpriteTexture &spriteTex)
+{
+    // ==== Opaque Span Table (RLE per column) ====
+
+    spriteTex.columnOffset.clear();
+    spriteTex.spans.clear();
+    spriteTex.columnOffset.reserve(width + 1);
+
+    for (int x = 0; x < width; ++x)
+    {
+        spriteTex.columnOffset.push_back(static_cast<int>(spriteTex.spans.size()));
+
+        int y = 0;
+        while (y < height)
+        {
+            // Skip transparent run
+            while (y < height && pixels[y * width + x].a == 0) ++y;
+            if (y >= height) break;
+
+            OpaqueSpan span;
+            span.start = static_cast<unsigned short>(y);
+
+            while (y < height && pixels[y * width + x].a > 0) ++y;
+            span.end = static_cast<unsigned short>(y);
+
+            spriteTex.spans.push_back(span);
+        }
+    }
+    spriteTex.columnOffset.push_back(static_cast<int>(spriteTex.spans.size()));
+}
+
+Camera2D RayCasting::render2D(Camera2D camera,Player player, Render render, Tilemap map, const WorldState &world, MinimapCache &minimap, const Viewport &viewport)
+{
+    // Apply only tile change since last draw (streamed world has no whole map layer, fan only)
+    if (world.stream == nullptr) RayCasting::syncMinimap(minimap, world);
+
+    // Only tile inside the screen is drawn
+    TileRect visible = RayCasting::visibleTiles(camera, world);
+
+    // Using camera2D render for map
+    BeginMode2D(camera);
+    
+    // Camera follow player position
+    camera.target = (Vector2)
+    {
+        .x = player.position.x + 20.0f,
+        .y = player.position.y + 20.0f
+    };
+    // Camera follow player offset (Center)
+    camera.offset = (Vector2)
+    {
+        .x = static_cast<float>(GetScreenWidth() / 2.0f),
+        .y = static_cast<float>(GetScreenHeight() / 2.0f)
+    };
+
+    if (world.stream != nullptr)
+    {
+        // Streamed world: no whole map tile layer, only the fan below
+    }
+    else if (TILE_SIZE * camera.zoom < MINIMAP_LOD_PIXEL)
+    {
+        // Zoomed out: merged LOD rectangle, wall never vanish like point sampled texture
+        RayCasting::drawMinimapLod(minimap, visible, camera.zoom);
+    }
+    else if (visible.right > visible.left && visible.bottom > visible.top)
+    {
+        // Draw visible part of cached tilemap layer (one draw call)
+        DrawTexturePro(
+            minimap.texture,
+            (Rectangle)
+            {
+                static_cast<float>(visible.left),
+                static_cast<float>(visible.top),
+                static_cast<float>(visible.right - visible.left),
+                static_cast<float>(visible.bottom - visible.top)
+            },
+            (Rectangle)
+            {
+                static_cast<float>(visible.left * TILE_SIZE),
+                static_cast<float>(visible.top * TILE_SIZE),
+                static_cast<float>((visible.right - visible.left) * TILE_SIZE),
+                static_cast<float>((visible.bottom - visible.top) * TILE_SIZE)
+            },
+            (Vector2){0.0f, 0.0f},
+            0.0f,
+            WHITE
+        );
+    }
+
+    // ==== Visibility Fan ====
+
+    minimap.fan.clear();
+    minimap.fan.push_back(player.position);
+
+    if (minimap.rayMode == MINIMAP_RAYS_FAN)
+    {
+        // Reuse column already cast for 3D view, no extra ray
+        const RenderView &view = viewport.view;
+
+        const Vector2 dir = (Vector2){ cosf(player.angle), sinf(player.angle) };
+        const Vector2 plane = (Vector2){ -dir.y * view.planeLength, dir.x * view.planeLength };
+
+        // Fan must be counter-clockwise on screen, so walk column right to left
+        for (int i = view.columnCount; i >= 0; --i)
+        {
+            // Extra last column close the fan at the right edge of FOV
+            const ColumnHit &column = viewport.temporal.columns[std::min(i, view.columnCount - 1)];
+            float cameraX = 2.0f * static_cast<float>(i) / static_cast<float>(view.columnCount) - 1.0f;
+
+            // Not normalized ray: dir component is 1, so perpendicular depth scale it directly
+            render.rayDir = (Vector2){ dir.x + plane.x * cameraX, dir.y + plane.y * cameraX };
+            float depth = column.hit ? column.distance : RAY_LENGTH / Vector2Length(render.rayDir);
+
+            render.rayPos = (Vector2)
+            {
+                player.position.x + render.rayDir.x * depth,
+                player.position.y + render.rayDir.y * depth
+            };
+            minimap.fan.push_back(render.rayPos);
+        }
+    }
+    else
+    {
+        RayCasting::buildVisibility(minimap, player, map, world);
+    }
+
+    // Whole visible area in one draw call
+    DrawTriangleFan(minimap.fan.data(), static_cast<int>(minimap.fan.size()), Fade(player.rayColor, 0.35f));
+
+    if (minimap.outline)
+    {
+        minimap.fan.push_back(player.position);
+        DrawLineStrip(minimap.fan.data(), static_cast<int>(minimap.fan.size()), player.rayColor);
+    }
+
+    // Render 2D player
+    DrawCircleV(player.position, 6, player.mainColor);
+
+    EndMode2D();
+
+    return camera;
+}
+
+void RayCasting::bakeMinimap(MinimapCache &minimap, const WorldState &world)
+{
+    // New map size need a new texture
+    if (minimap.texture.id != 0 && (minimap.width != world.width || minimap.height != world.height))
+    {
+        UnloadTexture(minimap.texture);
+        minimap.texture = (Texture){};
+    }
+
+    minimap.width = world.width;
+    minimap.height = world.height;
+    minimap.pixels.resize(world.width * world.height);
+
+    for (int i = 0; i < world.height; ++i)
+    {
+        for (int j = 0; j < world.width; ++j)
+        {
+            // Door is drawn faded, more when more open
+            if (world.tiles[i][j] == TILE_DOOR) minimap.pixels[i * world.width + j] = Fade(GRAY, 1.0f - 0.75f * world.doorOpen[i][j]);
+            else minimap.pixels[i * world.width + j] = (world.tiles[i][j] > 0) ? GRAY : BLANK;
+        }
+    }
+
+    // ==== Coarse LOD Pyramid ====
+
+    minimap.lodSolid.clear();
+    minimap.lodSolid.emplace_back(world.width * world.height);
+    for (int i = 0; i < world.width * world.height; ++i) minimap.lodSolid[0][i] = minimap.pixels[i].a > 0;
+
+    int levelWidth = world.width;
+    int levelHeight = world.height;
+
+    while (levelWidth > 1 || levelHeight > 1)
+    {
+        int nextWidth = (levelWidth + 1) / 2;
+        int nextHeight = (levelHeight + 1) / 2;
+
+        std::vector<unsigned char> next(nextWidth * nextHeight, 0);
+        const std::vector<unsigned char> &prev = minimap.lodSolid.back();
+
+        for (int y = 0; y < levelHeight; ++y)
+        {
+            for (int x = 0; x < levelWidth; ++x)
+            {
+                next[(y / 2) * nextWidth + (x / 2)] |= prev[y * levelWidth + x];
+            }
+        }
+
+        minimap.lodSolid.push_back(std::move(next));
+        levelWidth = nextWidth;
+        levelHeight = nextHeight;
+    }
+
+    if (minimap.texture.id == 0)
+    {
+        Image image = (Image)
+        {
+            .data = minimap.pixels.data(),
+            .width = world.width,
+            .height = world.height,
+            .mipmaps = 1,
+            .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+        };
+
+        minimap.texture = LoadTextureFromImage(image);
+        // Keep hard tile edge when scaled up
+        SetTextureFilter(minimap.texture, TEXTURE_FILTER_POINT);
+    }
+    else
+    {
+        UpdateTexture(minimap.texture, minimap.pixels.data());
+    }
+
+    minimap.version = world.version;
+    minimap.valid = true;
+}
+
+void RayCasting::syncMinimap(MinimapCache &minimap, const WorldState &world)
+{
+    if (minimap.valid && minimap.version == world.version) return;
+
+    // Change log already trimmed past our version, rebake everything
+    if (!minimap.valid || minimap.version < world.firstVersion)
+    {
+        RayCasting::bakeMinimap(minimap, world);
+        return;
+    }
+
+    for (const TileChange &change : world.changes)
+    {
+        if (change.version > minimap.version) RayCasting::updateMinimap(minimap, world, change.rect);
+    }
+
+    minimap.version = world.version;
+}
+
+void RayCasting::updateMinimap(MinimapCache &minimap, const WorldState &world, TileRect rect)
+{
+    int width = rect.right - rect.left;
+    int height = rect.bottom - rect.top;
+    if (width <= 0 || height <= 0) return;
+
+    // Sub buffer of changed tile only, upload with UpdateTextureRec
+    std::vector<Color> region(width * height);
+
+    for (int i = rect.top; i < rect.bottom; ++i)
+    {
+        for (int j = rect.left; j < rect.right; ++j)
+        {
+            Color color = (world.tiles[i][j] > 0) ? GRAY : BLANK;
+            if (world.tiles[i][j] == TILE_DOOR) color = Fade(GRAY, 1.0f - 0.75f * world.doorOpen[i][j]);
+
+            minimap.pixels[i * world.width + j] = color;
+            region[(i - rect.top) * width + (j - rect.left)] = color;
+            minimap.lodSolid[0][i * world.width + j] = color.a > 0;
+        }
+    }
+
+    UpdateTextureRec(
+        minimap.texture,
+        (Rectangle){ static_cast<float>(rect.left), static_cast<float>(rect.top), static_cast<float>(width), static_cast<float>(height) },
+        region.data()
+    );
+
+    // ==== Coarse LOD Pyramid (only cell over the rect) ====
+
+    int levelWidth = world.width;
+    int levelHeight = world.height;
+
+    for (std::size_t level = 1; level < minimap.lodSolid.size(); ++level)
+    {
+        int nextWidth = (levelWidth + 1) / 2;
+        int nextHeight = (levelHeight + 1) / 2;
+
+        rect = (TileRect){ rect.left / 2, rect.top / 2, (rect.right + 1) / 2, (rect.bottom + 1) / 2 };
+
+        const std::vector<unsigned char> &prev = minimap.lodSolid[level - 1];
+        std::vector<unsigned char> &next = minimap.lodSolid[level];
+
+        for (int y = rect.top; y < rect.bottom; ++y)
+        {
+            for (int x = rect.left; x < rect.right; ++x)
+            {
+                unsigned char solid = 0;
+                for (int k = 0; k < 4; ++k)
+                {
+                    int px = x * 2 + (k & 1);
+                    int py = y * 2 + (k >> 1);
+                    if (px < levelWidth && py < levelHeight) solid |= prev[py * levelWidth + px];
+                }
+                next[y * nextWidth + x] = solid;
+            }
+        }
+
+        levelWidth = nextWidth;
+        levelHeight = nextHeight;
+    }
+}
+
+void RayCasting::unloadMinimap(MinimapCache &minimap)
+{
+    if (minimap.texture.id != 0) UnloadTexture(minimap.texture);
+    minimap.texture = (Texture){0};
+}
+
+Vector2 RayCasting::castExact(Tilemap map, Vector2 origin, Vector2 rayDir, const WorldState &world)
+{
+    // Grid DDA, stop exactly on the wall edge (no RAY_STEP error)
+    map.mapX = static_cast<int>(origin.x / TILE_SIZE);
+    map.mapY = static_cast<int>(origin.y / TILE_SIZE);
+
+    float deltaX = (rayDir.x == 0.0f) ? 1e30f : fabsf(TILE_SIZE / rayDir.x);
+    float deltaY = (rayDir.y == 0.0f) ? 1e30f : fabsf(TILE_SIZE / rayDir.y);
+
+    int stepX = (rayDir.x < 0.0f) ? -1 : 1;
+    int stepY = (rayDir.y < 0.0f) ? -1 : 1;
+
+    float sideX = (rayDir.x < 0.0f) ? (origin.x - map.mapX * TILE_SIZE) / TILE_SIZE * deltaX : ((map.mapX + 1) * TILE_SIZE - origin.x) / TILE_SIZE * deltaX;
+    float sideY = (rayDir.y < 0.0f) ? (origin.y - map.mapY * TILE_SIZE) / TILE_SIZE * deltaY : ((map.mapY + 1) * TILE_SIZE - origin.y) / TILE_SIZE * deltaY;
+
+    float distance = 0.0f;
+
+    while (distance < RAY_LENGTH)
+    {
+        if (sideX < sideY)
+        {
+            distance = sideX;
+            sideX += deltaX;
+            map.mapX += stepX;
+        }
+        else
+        {
+            distance = sideY;
+            sideY += deltaY;
+            map.mapY += stepY;
+        }
+
+        if (map.mapX < 0 || map.mapY < 0 || map.mapX >= world.width || map.mapY >= world.height) break;
+        if (World::isBlocked(world, map.mapX, map.mapY)) break;
+    }
+
+    distance = fminf(distance, RAY_LENGTH);
+
+    return (Vector2)
+    {
+        origin.x + rayDir.x * distance,
+        origin.y + rayDir.y * distance
+    };
+}
+
+void RayCasting::buildVisibility(MinimapCache &minimap, Player player, Tilemap map, const WorldState &world)
+{
+    // Exact visibility change only at wall corner, so cast only toward corner
+    const float epsilon = 0.0005f;
+
+    minimap.cornerAngle.clear();
+    minimap.cornerAngle.push_back(-FOV / 2.0f);
+    minimap.cornerAngle.push_back(FOV / 2.0f);
+
+    // Grid vertex in range of RAY_LENGTH
+    int left = std::max(0, static_cast<int>((player.position.x - RAY_LENGTH) / TILE_SIZE));
+    int top = std::max(0, static_cast<int>((player.position.y - RAY_LENGTH) / TILE_SIZE));
+    int right = std::min(world.width, static_cast<int>((player.position.x + RAY_LENGTH) / TILE_SIZE) + 1);
+    int bottom = std::min(world.height, static_cast<int>((player.position.y + RAY_LENGTH) / TILE_SIZE) + 1);
+
+    for (int gy = top; gy <= bottom; ++gy)
+    {
+        for (int gx = left; gx <= right; ++gx)
+        {
+            // Four tile around this vertex (outside map count as solid)
+            auto solid = [&](int x, int y) { return x < 0 || y < 0 || x >= world.width || y >= world.height || World::isBlocked(world, x, y); };
+            bool a = solid(gx - 1, gy - 1);
+            bool b = solid(gx, gy - 1);
+            bool c = solid(gx - 1, gy);
+            bool d = solid(gx, gy);
+
+            int count = a + b + c + d;
+            if (count == 0 || count == 4) continue;
+
+            // Straight wall edge, not a corner
+            if (count == 2 && ((a && b) || (c && d) || (a && c) || (b && d))) continue;
+
+            float angle = atan2f(gy * TILE_SIZE - player.position.y, gx * TILE_SIZE - player.position.x) - player.angle;
+            angle = atan2f(sinf(angle), cosf(angle));
+
+            if (fabsf(angle) > FOV / 2.0f) continue;
+
+            // Ray just before, on and after the corner
+            minimap.cornerAngle.push_back(angle - epsilon);
+            minimap.cornerAngle.push_back(angle);
+            minimap.cornerAngle.push_back(angle + epsilon);
+        }
+    }
+
+    // Counter-clockwise on screen: biggest angle first
+    std::sort(minimap.cornerAngle.begin(), minimap.cornerAngle.end(), [](float a, float b) { return a > b; });
+
+    for (float angle : minimap.cornerAngle)
+    {
+        angle = Clamp(angle, -FOV / 2.0f, FOV / 2.0f);
+
+        Vector2 rayDir = (Vector2){ cosf(player.angle + angle), sinf(player.angle + angle) };
+        minimap.fan.push_back(RayCasting::castExact(map, player.position, rayDir, world));
+    }
+}
+
+TileRect RayCasting::visibleTiles(Camera2D camera, const WorldState &world)
+{
+    // Screen corner in world space (camera.target, offset and zoom)
+    Vector2 corner[4] = {
+        GetScreenToWorld2D((Vector2){0.0f, 0.0f}, camera),
+        GetScreenToWorld2D((Vector2){static_cast<float>(GetScreenWidth()), 0.0f}, camera),
+        GetScreenToWorld2D((Vector2){0.0f, static_cast<float>(GetScreenHeight())}, camera),
+        GetScreenToWorld2D((Vector2){static_cast<float>(GetScreenWidth()), static_cast<float>(GetScreenHeight())}, camera)
+    };
+
+    float minX = corner[0].x, maxX = corner[0].x;
+    float minY = corner[0].y, maxY = corner[0].y;
+    for (int i = 1; i < 4; ++i)
+    {
+        minX = fminf(minX, corner[i].x);
+        maxX = fmaxf(maxX, corner[i].x);
+        minY = fminf(minY, corner[i].y);
+        maxY = fmaxf(maxY, corner[i].y);
+    }
+
+    TileRect rect;
+    rect.left = std::clamp(static_cast<int>(floorf(minX / TILE_SIZE)), 0, world.width);
+    rect.top = std::clamp(static_cast<int>(floorf(minY / TILE_SIZE)), 0, world.height);
+    rect.right = std::clamp(static_cast<int>(ceilf(maxX / TILE_SIZE)), 0, world.width);
+    rect.bottom = std::clamp(static_cast<int>(ceilf(maxY / TILE_SIZE)), 0, world.height);
+
+    return rect;
+}
+
+void RayCasting::drawMinimapLod(const MinimapCache &minimap, TileRect rect, float zoom)
+{
+    // Pick level so one LOD cell is at least MINIMAP_LOD_PIXEL on screen
+    int level = 0;
+    while (level + 1 < static_cast<int>(minimap.lodSolid.size()) && TILE_SIZE * zoom * (1 << level) < MINIMAP_LOD_PIXEL) ++level;
+
+    const int cell = 1 << level;
+    const int levelWidth = (minimap.width + cell - 1) / cell;
+    const std::vector<unsigned char> &solid = minimap.lodSolid[level];
+
+    int left = rect.left / cell;
+    int top = rect.top / cell;
+    int right = (rect.right + cell - 1) / cell;
+    int bottom = (rect.bottom + cell - 1) / cell;
+
+    // Merge horizontal run of solid cell into one rectangle
+    for (int y = top; y < bottom; ++y)
+    {
+        int runStart = -1;
+
+        for (int x = left; x <= right; ++x)
+        {
+            bool isSolid = x < right && solid[y * levelWidth + x];
+
+            if (isSolid && runStart < 0) runStart = x;
+
+            if (!isSolid && runStart >= 0)
+            {
+                // Last cell may stick out of map, clip it
+                DrawRectangle(
+                    runStart * cell * TILE_SIZE,
+                    y * cell * TILE_SIZE,
+                    std::min((x - runStart) * cell, minimap.width - runStart * cell) * TILE_SIZE,
+                    std::min(cell, minimap.height - y * cell) * TILE_SIZE,
+                    GRAY
+                );
+                runStart = -1;
+            }
+        }
+    }
+}
+
+RenderView RayCasting::makeView(int x, int y, int width, int height, int columnCount)
+{
+    RenderView view;
+
+    view.x = static_cast<float>(x);
+    view.y = static_cast<float>(y);
+    view.columnCount = columnCount;
+
+    view.width = static_cast<float>(width);
+    view.height = static_cast<float>(height);
+    view.halfWidth = view.width / 2.0f;
+    view.halfHeight = view.height / 2.0f;
+    view.columnWidth = view.width / static_cast<float>(columnCount);
+    view.planeLength = tanf(FOV / 2.0f);
+
+    return view;
+}
+
+void RayCasting::layoutViewports(std::array<Viewport, MAX_PLAYERS> &viewports, int count, int width, int height)
+{
+    // 1 full screen, 2 side by side, 3 - 4 grid 2 x 2
+    int cols = (count == 1) ? 1 : 2;
+    int rows = (count <= 2) ? 1 : 2;
+
+    int viewWidth = width / cols;
+    int viewHeight = height / rows;
+
+    for (int i = 0; i < count; ++i)
+    {
+        // Same column density as full screen, so total ray stay RAY_COUNT per row
+        viewports[i].view = RayCasting::makeView((i % cols) * viewWidth, (i / cols) * viewHeight, viewWidth, viewHeight, RAY_COUNT / cols);
+
+        // Column range change, old column result is not valid
+        viewports[i].temporal.valid = false;
+    }
+}
+
+Upscaler RayCasting::loadUpscaler(int width, int height)
+{
+    Upscaler upscaler;
+
+    upscaler.target = LoadRenderTexture(width, height);
+    upscaler.sharp = (RenderTexture2D){0};
+    upscaler.sharpScale = 0;
+    upscaler.filter = UPSCALE_NEAREST;
+    upscaler.appliedFilter = -1;
+
+    return upscaler;
+}
+
+void RayCasting::present(Upscaler &upscaler)
+{
+    const float width = static_cast<float>(upscaler.target.texture.width);
+    const float height = static_cast<float>(upscaler.target.texture.height);
+
+    // Keep aspect ratio, letterbox the rest of window
+    float scale = fminf(GetScreenWidth() / width, GetScreenHeight() / height);
+
+    Rectangle dst = (Rectangle)
+    {
+        .x = (GetScreenWidth() - width * scale) / 2.0f,
+        .y = (GetScreenHeight() - height * scale) / 2.0f,
+        .width = width * scale,
+        .height = height * scale
+    };
+
+    // Render texture is flipped in Y
+    Rectangle src = (Rectangle){0.0f, 0.0f, width, -height};
+
+    // Sharp prescale always sample internal target with nearest
+    int targetFilter = upscaler.filter == UPSCALE_BILINEAR ? TEXTURE_FILTER_BILINEAR : TEXTURE_FILTER_POINT;
+    if (targetFilter != upscaler.appliedFilter)
+    {
+        SetTextureFilter(upscaler.target.texture, targetFilter);
+        upscaler.appliedFilter = targetFilter;
+    }
+
+    if (upscaler.filter != UPSCALE_SHARP)
+    {
+        DrawTexturePro(upscaler.target.texture, src, dst, (Vector2){0.0f, 0.0f}, 0.0f, WHITE);
+        return;
+    }
+
+    // ==== Sharp Bilinear ====
+    // Nearest to the largest integer scale, then bilinear for the fraction left
+
+    int sharpScale = (scale < 1.0f) ? 1 : static_cast<int>(scale);
+    if (sharpScale != upscaler.sharpScale)
+    {
+        if (upscaler.sharpScale > 0) UnloadRenderTexture(upscaler.sharp);
+
+        upscaler.sharp = LoadRenderTexture(static_cast<int>(width) * sharpScale, static_cast<int>(height) * sharpScale);
+        SetTextureFilter(upscaler.sharp.texture, TEXTURE_FILTER_BILINEAR);
+        upscaler.sharpScale = sharpScale;
+    }
+
+    BeginTextureMode(upscaler.sharp);
+    DrawTexturePro(
+        upscaler.target.texture,
+        src,
+        (Rectangle){0.0f, 0.0f, width * sharpScale, height * sharpScale},
+        (Vector2){0.0f, 0.0f},
+        0.0f,
+        WHITE
+    );
+    EndTextureMode();
+
+    DrawTexturePro(
+        upscaler.sharp.texture,
+        (Rectangle){0.0f, 0.0f, width * sharpScale, -height * sharpScale},
+        dst,
+        (Vector2){0.0f, 0.0f},
+        0.0f,
+        WHITE
+    );
+}
+
+void RayCasting::unloadUpscaler(Upscaler upscaler)
+{
+    UnloadRenderTexture(upscaler.target);
+    if (upscaler.sharpScale > 0) UnloadRenderTexture(upscaler.sharp);
+}
+
+void RayCasting::projectSprites(RenderView view, Player player, const SpriteBatch &sprites, SpriteProjection &proj)
+{
+    const std::size_t count = sprites.posX.size();
+
+    const float screenWidth = view.width;
+    const float screenHeight = view.height;
+    const float halfWidth = view.halfWidth;
+
+    // Camera basis: direction and plane (plane length = tan(FOV / 2))
+    const float dirX = cosf(player.angle);
+    const float dirY = sinf(player.angle);
+    const float planeX = -dirY * view.planeLength;
+    const float planeY = dirX * view.planeLength;
+
+    // Inverse camera matrix [planeX dirX; planeY dirY]
+    const float invDet = 1.0f / (planeX * dirY - dirX * planeY);
+
+    // No allocation after first frame (capacity stay)
+    proj.transformX.resize(count);
+    proj.transformY.resize(count);
+    proj.screenX.resize(count);
+    proj.size.resize(count);
+    proj.order.clear();
+
+    const float *posX = sprites.posX.data();
+    const float *posY = sprites.posY.data();
+    const float *scale = sprites.scale.data();
+    float *transformX = proj.transformX.data();
+    float *transformY = proj.transformY.data();
+    float *screenX = proj.screenX.data();
+    float *size = proj.size.data();
+
+    // Transform whole batch without branch, so compiler can vectorize it
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        float dx = posX[i] - player.position.x;
+        float dy = posY[i] - player.position.y;
+
+        float tx = invDet * (dirY * dx - dirX * dy);
+        float ty = invDet * (-planeY * dx + planeX * dy);
+        float depth = fmaxf(ty, NEAR_PLANE);
+
+        transformX[i] = tx;
+        transformY[i] = ty;
+        screenX[i] = halfWidth * (1.0f + tx / depth);
+        size[i] = (screenHeight * scale[i]) / depth;
+    }
+
+    // Cull sprite behind camera or outside screen
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (transformY[i] <= NEAR_PLANE) continue;
+        if (screenX[i] + size[i] / 2 < 0.0f || screenX[i] - size[i] / 2 >= screenWidth) continue;
+
+        proj.order.push_back(static_cast<int>(i));
+    }
+
+    // Sort far to near, so near sprite is drawn last
+    std::sort(proj.order.begin(), proj.order.end(), [&](int a, int b)
+    {
+        return transformY[a] > transformY[b];
+    });
+}
+
+Vector2 RayCasting::columnRayDir(Vector2 dir, Vector2 plane, int column, int columnCount)
+{
+    // Column position in camera plane [-1, 1)
+    float cameraX = 2.0f * static_cast<float>(column) / static_cast<float>(columnCount) - 1.0f;
+
+    return Vector2Normalize((Vector2)
+    {
+        dir.x + plane.x * cameraX,
+        dir.y + plane.y * cameraX
+    });
+}
+
+ColumnHit RayCasting::castColumn(Render render, Tilemap map, RenderTextureMapping texMap, Vector2 origin, Vector2 dir, Vector2 rayDir, const WorldState &world)
+{
+    ColumnHit column = (ColumnHit){0};
+
+    render.rayDir = rayDir;
+    render.rayPos = origin;
+    render.distance = 0;
+    render.hit = false;
+    texMap.hitVertical = false;
+
+    map.hitTile = 0;
+
+    // Door or partial wall tile the ray already pass through
+    int passX = -1;
+    int passY = -1;
+
+    // Highest partial wall top so far, as (0.5 - height) / depth (smaller = higher on screen)
+    float coverSlope = 1e30f;
+
+    while (render.distance < RAY_LENGTH && !render.hit)
+    {
+        render.rayPos.x += render.rayDir.x * RAY_STEP;
+        render.rayPos.y += render.rayDir.y * RAY_STEP;
+        render.distance += RAY_STEP;
+
+        map.mapX = render.rayPos.x / TILE_SIZE;
+        map.mapY = render.rayPos.y / TILE_SIZE;
+
+        if (map.mapX < 0 || map.mapY < 0 || map.mapX >= world.width || map.mapY >= world.height) break;
+
+        int runLeft = 0;
+        int runRight = 0;
+        int tile = World::tileRun(world, map.mapX, map.mapY, runLeft, runRight);
+
+        // Chunk still loading, column end here and is complete in a later frame
+        if (tile == CHUNK_PENDING)
+        {
+            column.pending = true;
+            break;
+        }
+
+        if (tile == 0)
+        {
+            // Streamed world has no distance field, walk the empty run instead:
+            // skip every step still inside the run and this row, each skipped step is empty for sure
+            if (world.stream != nullptr)
+            {
+                float runX = (render.rayDir.x > 0.0f) ? runRight * TILE_SIZE - render.rayPos.x : render.rayPos.x - runLeft * TILE_SIZE;
+                float rowY = (render.rayDir.y > 0.0f) ? (map.mapY + 1) * TILE_SIZE - render.rayPos.y : render.rayPos.y - map.mapY * TILE_SIZE;
+                float steps = fminf(
+                    fminf(runX / (fabsf(render.rayDir.x) * RAY_STEP + 1e-6f), rowY / (fabsf(render.rayDir.y) * RAY_STEP + 1e-6f)),
+                    (RAY_LENGTH - render.distance) / RAY_STEP
+                );
+
+                int skip = static_cast<int>(steps) - 1;
+                if (skip > 0)
+                {
+                    render.rayPos.x += render.rayDir.x * RAY_STEP * skip;
+                    render.rayPos.y += render.rayDir.y * RAY_STEP * skip;
+                    render.distance += RAY_STEP * skip;
+                }
+                continue;
+            }
+
+            // Empty space skip: no solid closer than distance - 1 tile, jump whole step at once
+            int skip = static_cast<int>((world.distance[map.mapY][map.mapX] - 1) * TILE_SIZE / (RAY_STEP * fmaxf(fabsf(render.rayDir.x), fabsf(render.rayDir.y))));
+            if (skip > 1)
+            {
+                skip = std::min(skip - 1, static_cast<int>((RAY_LENGTH - render.distance) / RAY_STEP));
+                render.rayPos.x += render.rayDir.x * RAY_STEP * skip;
+                render.rayPos.y += render.rayDir.y * RAY_STEP * skip;
+                render.distance += RAY_STEP * skip;
+            }
+            continue;
+        }
+
+        if (map.mapX == passX && map.mapY == passY) continue;
+
+        {
+            texMap.dx = fminf(
+                fabsf(render.rayPos.x - map.mapX * TILE_SIZE),
+                fabsf(render.rayPos.x - (map.mapX + 1) * TILE_SIZE)
+            );
+            texMap.dy = fminf(
+                fabsf(render.rayPos.y - map.mapY * TILE_SIZE),
+                fabsf(render.rayPos.y - (map.mapY + 1) * TILE_SIZE)
+            );
+
+            texMap.hitVertical = texMap.dx < texMap.dy;
+            texMap.hitX = texMap.hitVertical ? fmodf(render.rayPos.y, TILE_SIZE) / TILE_SIZE : fmodf(render.rayPos.x, TILE_SIZE) / TILE_SIZE;
+
+            // Door panel slide aside by open ratio, ray in the opening go through
+            if (tile == TILE_DOOR && world.stream == nullptr && texMap.hitX < world.doorOpen[map.mapY][map.mapX])
+            {
+                passX = map.mapX;
+                passY = map.mapY;
+                continue;
+            }
+
+            const TileInfo &info = tileInfo[tile];
+            float depth = render.distance * Vector2DotProduct(render.rayDir, dir);
+
+            // Wall up to full height behind the cover is hidden, column is done
+            bool covered = coverSlope <= -0.5f / depth;
+            bool isLayer = (info.height < 1.0f || info.seeThrough) && !covered;
+
+            // Layer buffer full: see-through tile become the last hit
+            if (isLayer && info.seeThrough && column.layerCount == MAX_HITS - 1) isLayer = false;
+
+            if (isLayer)
+            {
+                // Keep partial wall only when its top still show above nearer one, see-through always
+                float slope = (0.5f - info.height) / depth;
+
+                if (info.seeThrough || (slope < coverSlope && column.layerCount < MAX_HITS - 1))
+                {
+                    bool flip = (!texMap.hitVertical && render.rayDir.y < 0) || (texMap.hitVertical && render.rayDir.x > 0);
+                    column.layers[column.layerCount++] = (WallHit){ tile, map.mapX, map.mapY, texMap.hitVertical, flip, depth, Clamp(texMap.hitX, 0.0f, 1.0f) };
+
+                    // Transparent texel cover nothing for sure
+                    if (!info.seeThrough) coverSlope = slope;
+                }
+
+                passX = map.mapX;
+                passY = map.mapY;
+                continue;
+            }
+
+            render.hit = true;
+            map.hitTile = tile;
+        }
+    }
+
+    if (!render.hit) return column;
+
+    column.hit = true;
+    column.tile = map.hitTile;
+    column.mapX = map.mapX;
+    column.mapY = map.mapY;
+    column.hitVertical = texMap.hitVertical;
+
+    // Fish-eye correction (perpendicular distance to camera plane)
+    column.distance = render.distance * Vector2DotProduct(render.rayDir, dir);
+
+    // Door texture move with the panel
+    if (column.tile == TILE_DOOR && world.stream == nullptr) texMap.hitX -= world.doorOpen[column.mapY][column.mapX];
+    column.hitX = Clamp(texMap.hitX, 0.0f, 1.0f);
+
+    // Flip texture
+    column.flip = (!texMap.hitVertical && render.rayDir.y < 0) || (texMap.hitVertical && render.rayDir.x > 0);
+
+    return column;
+}
+
+bool RayCasting::interpolateColumn(ColumnHit left, ColumnHit right, ColumnHit &out)
 {
-    // Rotate player
-    if (IsKeyDown(KEY_A)) player.angle -= 0.05f;
-    if (IsKeyDown(KEY_D)) player.angle += 0.05f;
+    // Edge aware: both neighbour must see the same face of the same tile
+    if (!left.hit || !right.hit) return false;
+    if (left.mapX != right.mapX || left.mapY != right.mapY) return false;
+    if (left.hitVertical != right.hitVertical || left.flip != right.flip) return false;
+    if (left.layerCount > 0 || right.layerCount > 0) return false;
 
-    // Move player
-    if (IsKeyDown(KEY_W))
+    // Wall face is a plane, so 1 / depth and hitX / depth are linear on screen
+    float invDepth = 0.5f * (1.0f / left.distance + 1.0f / right.distance);
+
+    out = left;
+    out.distance = 1.0f / invDepth;
+    out.hitX = Clamp(0.5f * (left.hitX / left.distance + right.hitX / right.distance) / invDepth, 0.0f, 1.0f);
+
+    return true;
+}
+
+void RayCasting::startScheduler(CastScheduler &scheduler, int threadCount)
+{
+    scheduler.world = nullptr;
+    scheduler.cameras = nullptr;
+    scheduler.snapshots = nullptr;
+    scheduler.snapshotConfig = nullptr;
+    scheduler.taskCount = 0;
+    scheduler.next = 0;
+    scheduler.remaining = 0;
+    scheduler.busy = 0;
+    scheduler.open = false;
+    scheduler.quit = false;
+    scheduler.generation = 0;
+
+    // Main thread is a worker too, so start threadCount - 1
+    for (int i = 1; i < threadCount; ++i)
     {
-        player.position.x += cosf(player.angle) * player.speed;
-        player.position.y += sinf(player.angle) * player.speed;
+        scheduler.workers.emplace_back([&scheduler]()
+        {
+            unsigned int seen = 0;
+
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(scheduler.mutex);
+                    scheduler.wake.wait(lock, [&]() { return scheduler.quit || (scheduler.open && scheduler.generation != seen); });
+                    if (scheduler.quit) return;
+
+                    seen = scheduler.generation;
+                    scheduler.busy++;
+                }
+
+                RayCasting::drainScheduler(scheduler);
+
+                {
+                    std::lock_guard<std::mutex> lock(scheduler.mutex);
+                    scheduler.busy--;
+                }
+                scheduler.done.notify_all();
+            }
+        });
     }
-    if (IsKeyDown(KEY_S))
+}
+
+void RayCasting::stopScheduler(CastScheduler &scheduler)
+{
     {
-        player.position.x -= cosf(player.angle) * player.speed;
-        player.position.y -= sinf(player.angle) * player.speed;
+        std::lock_guard<std::mutex> lock(scheduler.mutex);
+        scheduler.quit = true;
     }
-    return player;
+    scheduler.wake.notify_all();
+
+    for (auto &worker : scheduler.workers) worker.join();
+    scheduler.workers.clear();
 }
 
-Player Game::collision(Player player, Vector2 oldPosPlayer, StaticObject obj, std::array<std::array<int, TILE_WIDTH>, TILE_HEIGHT> worldMap)
+void RayCasting::scheduleColumns(CastScheduler &scheduler, Viewport &viewport, Player player)
 {
-    // ==== WorldMap Collision ====
+    const RenderView &view = viewport.view;
+    TemporalColumns &temporal = viewport.temporal;
 
-    int left   = (player.position.x - player.radius) / TILE_SIZE;
-    int right  = (player.position.x + player.radius) / TILE_SIZE;
-    int top    = (player.position.y - player.radius) / TILE_SIZE;
-    int bottom = (player.position.y + player.radius) / TILE_SIZE;
+    // Camera basis, same projection with sprite transform
+    const Vector2 dir = (Vector2)
+    {
+        cosf(player.angle),
+        sinf(player.angle)
+    };
+    const Vector2 plane = (Vector2)
+    {
+        -dir.y * view.planeLength,
+        dir.x * view.planeLength
+    };
+
+    temporal.stats = (TemporalStats){0};
+
+    const bool isCheckerboard = temporal.enabled && temporal.valid;
+    const int parity = temporal.frame & 1;
 
-    if (left < 0 || right >= TILE_WIDTH || top < 0 || bottom >= TILE_HEIGHT)
+    // Full cast, or only half of column (even / odd alternate each frame)
+    for (int i = 0; i < view.columnCount; ++i)
     {
-        player.position = oldPosPlayer;
-        return player;
+        if (isCheckerboard && (i & 1) != parity) continue;
+
+        scheduler.requests.push_back((CastRequest){player.position, dir, plane, i, view.columnCount, &temporal.columns[i]});
+        temporal.stats.cast++;
+    }
+}
+
+void RayCasting::runScheduler(CastScheduler &scheduler, const WorldState &world)
+{
+    if (scheduler.requests.empty()) return;
+
+    RayCasting::runBatch(scheduler, world, static_cast<int>(scheduler.requests.size()));
+
+    scheduler.requests.clear();
+}
+
+void RayCasting::runBatch(CastScheduler &scheduler, const WorldState &world, int taskCount)
+{
+    {
+        std::lock_guard<std::mutex> lock(scheduler.mutex);
+        scheduler.world = &world;
+        scheduler.taskCount = taskCount;
+        scheduler.next = 0;
+        scheduler.remaining = taskCount;
+        scheduler.open = true;
+        scheduler.generation++;
     }
+    scheduler.wake.notify_all();
+
+    RayCasting::drainScheduler(scheduler);
 
-    if (worldMap[top][left] > 0 || worldMap[top][right] > 0 || worldMap[bottom][left] > 0 || worldMap[bottom][right] > 0)
+    // Wait every task done and every worker out, then close this batch
     {
-        player.position = oldPosPlayer;
+        std::unique_lock<std::mutex> lock(scheduler.mutex);
+        scheduler.done.wait(lock, [&]() { return scheduler.remaining == 0 && scheduler.busy == 0; });
+        scheduler.open = false;
     }
+}
 
-    // ==== Static Object Collision ====
+void RayCasting::drainScheduler(CastScheduler &scheduler)
+{
+    // Scratch state own by this thread
+    Render render;
+    Tilemap map;
+    RenderTextureMapping texMap;
+
+    const int count = scheduler.taskCount;
+    int finished = 0;
 
-    float dx = player.position.x - obj.position.x;
-    float dy = player.position.y - obj.position.y;
+    // Snapshot batch: one camera per pull (a camera is a whole small image)
+    while (scheduler.cameras != nullptr)
+    {
+        int i = scheduler.next.fetch_add(1);
+        if (i >= count) break;
 
-    float dist = sqrtf(dx * dx + dy * dy);
+        RayCasting::renderSnapshot((*scheduler.cameras)[i], (*scheduler.snapshots)[i], *scheduler.snapshotConfig, *scheduler.world);
+        finished++;
+    }
 
-    if (dist < player.radius + obj.radius)
+    while (scheduler.cameras == nullptr)
     {
-        player.position = oldPosPlayer;
+        int begin = scheduler.next.fetch_add(CAST_BATCH);
+        if (begin >= count) break;
+
+        int end = std::min(begin + CAST_BATCH, count);
+        for (int i = begin; i < end; ++i)
+        {
+            const CastRequest &request = scheduler.requests[i];
+
+            *request.out = RayCasting::castColumn(render, map, texMap, request.origin, request.dir, RayCasting::columnRayDir(request.dir, request.plane, request.column, request.columnCount), *scheduler.world);
+        }
+        finished += end - begin;
     }
 
-    return player;
+    if (finished == 0) return;
+
+    {
+        std::lock_guard<std::mutex> lock(scheduler.mutex);
+        scheduler.remaining -= finished;
+    }
+    scheduler.done.notify_all();
 }
 
-Camera2D RayCasting::render2D(Camera2D camera,Player player, Render render, Tilemap map, std::array<std::array<int, TILE_WIDTH>, TILE_HEIGHT> worldMap)
+void RayCasting::renderSnapshot(CameraState camera, Snapshot &snapshot, const SnapshotConfig &config, const WorldState &world)
 {
-    // Using camera2D render for map
-    BeginMode2D(camera);
-    
-    // Camera follow player position
-    camera.target = (Vector2)
+    // Scratch state own by this call (thread safe)
+    Render render;
+    Tilemap map;
+    RenderTextureMapping texMap;
+
+    // No allocation after first call with same config
+    snapshot.depth.resize(config.width);
+    snapshot.tileId.resize(config.width);
+    if (config.withColor) snapshot.color.resize(config.width * config.height);
+
+    const Vector2 dir = (Vector2)
     {
-        .x = player.position.x + 20.0f,
-        .y = player.position.y + 20.0f
+        cosf(camera.angle),
+        sinf(camera.angle)
     };
-    // Camera follow player offset (Center)
-    camera.offset = (Vector2)
+    const Vector2 plane = (Vector2)
     {
-        .x = static_cast<float>(GetScreenWidth() / 2.0f),
-        .y = static_cast<float>(GetScreenHeight() / 2.0f)
+        -dir.y * tanf(FOV / 2.0f),
+        dir.x * tanf(FOV / 2.0f)
     };
 
-    // Draw tilemap
-    for (int i = 0; i < TILE_HEIGHT; ++i)
+    const float halfHeight = config.height / 2.0f;
+
+    for (int x = 0; x < config.width; ++x)
     {
-        for (int j = 0; j < TILE_WIDTH; ++j)
+        ColumnHit column = RayCasting::castColumn(render, map, texMap, camera.position, dir, RayCasting::columnRayDir(dir, plane, x, config.width), world);
+
+        snapshot.depth[x] = column.hit ? column.distance : RAY_LENGTH;
+        snapshot.tileId[x] = static_cast<unsigned char>(column.hit ? column.tile : 0);
+
+        if (!config.withColor) continue;
+
+        // Same wall height with render3D, flat color by tile and shade by distance
+        int top = config.height;
+        int bottom = config.height;
+        Color wallColor = BLANK;
+
+        if (column.hit)
         {
-            // Render 2D worldMap
-            if (worldMap[i][j] > 0)
+            float wallHeight = (config.height * 50) / column.distance;
+            top = std::max(0, static_cast<int>(halfHeight - wallHeight / 2));
+            bottom = std::min(config.height, static_cast<int>(halfHeight + wallHeight / 2));
+
+            float shade = Clamp(1.0f - (column.distance / MAX_DISTANCE), 0.2f, 1.0f);
+            Color base = (column.tile - 1 < static_cast<int>(config.palette.size())) ? config.palette[column.tile - 1] : WHITE;
+
+            wallColor = (Color)
             {
-                DrawRectangle(
-                    j * TILE_SIZE,
-                    i * TILE_SIZE,
-                    TILE_SIZE,
-                    TILE_SIZE,
-                    GRAY
-                );
-            }
+                .r = (unsigned char)(base.r * shade),
+                .g = (unsigned char)(base.g * shade),
+                .b = (unsigned char)(base.b * shade),
+                .a = 255
+            };
+        }
+
+        for (int y = 0; y < config.height; ++y)
+        {
+            Color pixel = (y < top) ? ((y < halfHeight) ? DARKGRAY : GRAY) : (y < bottom) ? wallColor : GRAY;
+            snapshot.color[y * config.width + x] = pixel;
         }
     }
+}
+
+SnapshotStats RayCasting::renderSnapshots(const std::vector<CameraState> &cameras, std::vector<Snapshot> &snapshots, const SnapshotConfig &config, const WorldState &world, CastScheduler &scheduler)
+{
+    SnapshotStats stats = (SnapshotStats){0};
+
+    stats.cameras = static_cast<int>(cameras.size());
+    stats.threads = std::max(1, std::min(static_cast<int>(scheduler.workers.size()) + 1, stats.cameras));
+
+    snapshots.resize(cameras.size());
+    if (cameras.empty()) return stats;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Parallel across camera on the cast worker pool (already running, no thread start here)
+    scheduler.cameras = &cameras;
+    scheduler.snapshots = &snapshots;
+    scheduler.snapshotConfig = &config;
 
-    // Cast rays
-    for (int i = 0; i < RAY_COUNT; i++)
+    RayCasting::runBatch(scheduler, world, stats.cameras);
+
+    scheduler.cameras = nullptr;
+    scheduler.snapshots = nullptr;
+    scheduler.snapshotConfig = nullptr;
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.camerasPerSecond = (stats.seconds > 0.0) ? stats.cameras / stats.seconds : 0.0;
+
+    return stats;
+}
+
+template<std::size_t N>
+void RayCasting::render3D(Viewport &viewport, Player player, Render render, RenderStaticObj renderObj, const SpriteBatch &sprites, const std::vector<SpriteTexture> &spriteTex, RenderTextureMapping texMap, Tilemap map, const std::array<SpriteTexture, N> &wallTex, const WorldState &world)
+{
+    const RenderView &view = viewport.view;
+    TemporalColumns &temporal = viewport.temporal;
+    SpriteProjection &proj = viewport.proj;
+    float *depthBuffer = viewport.depthBuffer;
+
+    // Camera basis, same projection with sprite transform
+    const Vector2 dir = (Vector2)
     {
-        render.rayAngle = player.angle - FOV / 2.0f + (float)i / RAY_COUNT * FOV;
+        cosf(player.angle),
+        sinf(player.angle)
+    };
+    const Vector2 plane = (Vector2)
+    {
+        -dir.y * view.planeLength,
+        dir.x * view.planeLength
+    };
 
-        render.rayDir = {
-            cosf(render.rayAngle),
-            sinf(render.rayAngle)
-        };
+    // ===== RESOLVE COLUMN =====
+    // Column of this parity is already cast by RayCasting::runScheduler
 
-        render.rayPos = player.position;
+    const bool isStatic = temporal.valid && player.position.x == temporal.lastPosition.x && player.position.y == temporal.lastPosition.y && player.angle == temporal.lastAngle && temporal.worldVersion == world.version;
+    const bool isCheckerboard = temporal.enabled && temporal.valid;
+    const int parity = temporal.frame & 1;
 
-        for (float j = 0; j < RAY_LENGTH; j += RAY_STEP)
+    // Fill the other half from previous frame or from neighbour
+    if (isCheckerboard)
+    {
+        for (int i = 1 - parity; i < view.columnCount; i += 2)
         {
-            render.rayPos.x += render.rayDir.x * RAY_STEP;
-            render.rayPos.y += render.rayDir.y * RAY_STEP;
+            // Camera not move, last frame result of this column is still exact
+            if (isStatic)
+            {
+                temporal.stats.reused++;
+                continue;
+            }
 
-            map.mapX = render.rayPos.x / TILE_SIZE;
-            map.mapY = render.rayPos.y / TILE_SIZE;
+            if (i > 0 && i < view.columnCount - 1 && RayCasting::interpolateColumn(temporal.columns[i - 1], temporal.columns[i + 1], temporal.columns[i]))
+            {
+                temporal.stats.interpolated++;
 
-            if (map.mapX < 0 || map.mapY < 0 || map.mapX >= TILE_WIDTH || map.mapY >= TILE_HEIGHT) break;
+                if (temporal.measureError)
+                {
+                    ColumnHit truth = RayCasting::castColumn(render, map, texMap, player.position, dir, RayCasting::columnRayDir(dir, plane, i, view.columnCount), world);
+                    float error = fabsf(temporal.columns[i].distance - truth.distance) / truth.distance;
 
-            if (worldMap[map.mapY][map.mapX] > 0)
-            {
-                // Render 2D raycast lines
-                DrawLineV(player.position, render.rayPos, player.rayColor);
-                break;
+                    temporal.stats.meanDepthError += error;
+                    temporal.stats.maxDepthError = fmaxf(temporal.stats.maxDepthError, error);
+                }
+                continue;
             }
+
+            // Edge between different tile or face, cast it for real
+            temporal.columns[i] = RayCasting::castColumn(render, map, texMap, player.position, dir, RayCasting::columnRayDir(dir, plane, i, view.columnCount), world);
+            temporal.stats.cast++;
+            temporal.stats.edgeCast++;
         }
-    }
 
-    // Render 2D player
-    DrawCircleV(player.position, 6, player.mainColor);
+        if (temporal.stats.interpolated > 0) temporal.stats.meanDepthError /= temporal.stats.interpolated;
+    }
 
-    EndMode2D();
+    temporal.valid = true;
+    temporal.frame++;
+    temporal.lastPosition = player.position;
+    temporal.lastAngle = player.angle;
+    temporal.worldVersion = world.version;
 
-    return camera;
-}
+    // ===== DRAW COLUMN =====
+    // Front to back with coverage mask: texel already covered or transparent is never drawn
 
-template<std::size_t N>
-void RayCasting::render3D(Player player, Render render, RenderStaticObj renderObj, StaticObject staticObj, RenderTextureMapping texMap, Tilemap map, std::array<Texture, N> wallTex, std::array<std::array<int, TILE_WIDTH>, TILE_HEIGHT> worldMap, float depthBuffer[RAY_COUNT])
-{
-    for (int i = 0; i < RAY_COUNT; ++i)
+    for (int i = 0; i < view.columnCount; ++i)
     {
-        render.rayAngle = player.angle - (FOV / 2.0f) + (static_cast<float>(i) / static_cast<float>(RAY_COUNT)) * FOV;
+        const ColumnHit &column = temporal.columns[i];
+
+        // No wall in this column, sprite always visible
+        depthBuffer[i] = column.hit ? column.distance : RAY_LENGTH;
 
-        render.rayDir = (Vector2)
+        std::bitset<RENDER_HEIGHT> &cover = viewport.cover[i];
+        cover.reset();
+        int covered = 0;
+
+        for (int k = 0; k < column.layerCount && covered < view.height; ++k)
         {
-            cosf(render.rayAngle),
-            sinf(render.rayAngle)
-        };
+            const WallHit &layer = column.layers[k];
 
-        render.rayPos = static_cast<Vector2>(player.position);
-        render.distance = 0;
-        render.hit = false;
-        texMap.hitVertical = false;
+            render.wallHeight = (view.height * 50) / layer.distance;
+            float floorY = view.halfHeight + render.wallHeight / 2;
 
-        map.hitTile = 0;
+            viewport.layerSpan[i][k] = (Vector2){ floorY - tileInfo[layer.tile].height * render.wallHeight, floorY };
+            covered += RayCasting::composeWall(view, i, layer, viewport.layerSpan[i][k], wallTex, cover, world);
+        }
 
-        while (render.distance < RAY_LENGTH && !render.hit)
+        // Column fully opaque already, hidden wall is not shaded
+        if (column.hit && covered < view.height)
         {
-            render.rayPos.x += render.rayDir.x * RAY_STEP;
-            render.rayPos.y += render.rayDir.y * RAY_STEP;
-            render.distance += RAY_STEP;
+            render.correctedDist = column.distance;
+            render.wallHeight = (view.height * 50) / render.correctedDist;
+
+            WallHit wall = (WallHit){ column.tile, column.mapX, column.mapY, column.hitVertical, column.flip, column.distance, column.hitX };
+            RayCasting::composeWall(view, i, wall, (Vector2){ view.halfHeight - render.wallHeight / 2, view.halfHeight + render.wallHeight / 2 }, wallTex, cover, world);
+        }
+    }
 
-            map.mapX = render.rayPos.x / TILE_SIZE;
-            map.mapY = render.rayPos.y / TILE_SIZE;
+    // ===== FLOOR DYNAMIC LIGHT =====
+    // Additive glow on floor row still open, sampled in band per column
+
+    if (toggleLighting && !world.dynamicLights.empty())
+    {
+        BeginBlendMode(BLEND_ADDITIVE);
+
+        for (int i = 0; i < view.columnCount; ++i)
+        {
+            Vector2 rayDir = RayCasting::columnRayDir(dir, plane, i, view.columnCount);
+            const std::bitset<RENDER_HEIGHT> &cover = viewport.cover[i];
 
-            if (map.mapX < 0 || map.mapY < 0 || map.mapX >= TILE_WIDTH || map.mapY >= TILE_HEIGHT) break;
+            // Ray is normalized, perpendicular depth is longer along the ray toward screen edge
+            float rayScale = 1.0f / Vector2DotProduct(rayDir, dir);
 
-            if (worldMap[map.mapY][map.mapX] > 0)
+            for (int band = 0; band < FLOOR_BANDS; ++band)
             {
-                render.hit = true;
-                map.hitTile = worldMap[map.mapY][map.mapX];
+                int top = static_cast<int>(view.halfHeight + band * view.halfHeight / FLOOR_BANDS) + 1;
+                int bottom = static_cast<int>(view.halfHeight + (band + 1) * view.halfHeight / FLOOR_BANDS);
 
-                texMap.dx = fminf(
-                    fabsf(render.rayPos.x - map.mapX * TILE_SIZE),
-                    fabsf(render.rayPos.x - (map.mapX + 1) * TILE_SIZE)
-                );
-                texMap.dy = fminf(
-                    fabsf(render.rayPos.y - map.mapY * TILE_SIZE),
-                    fabsf(render.rayPos.y - (map.mapY + 1) * TILE_SIZE)
-                );
+                // Floor row to perpendicular depth (same projection with wall height)
+                float depth = (view.height * 25) / ((top + bottom) / 2.0f - view.halfHeight);
+                Vector2 point = Vector2Add(player.position, Vector2Scale(rayDir, depth * rayScale));
+
+                float light = World::dynamicLight(world, point, (Vector2){ 0.0f, 0.0f });
+                if (light < 0.02f) continue;
+
+                Color glow = Fade(WHITE, fminf(light, 1.0f) * 0.5f);
 
-                texMap.hitVertical = texMap.dx < texMap.dy;
+                int y = top;
+                while (y < bottom)
+                {
+                    while (y < bottom && cover[y]) ++y;
+
+                    int runStart = y;
+                    while (y < bottom && !cover[y]) ++y;
+
+                    if (y > runStart) DrawRectangle(static_cast<int>(view.x + i * view.columnWidth), static_cast<int>(view.y) + runStart, static_cast<int>(view.columnWidth) + 1, y - runStart, glow);
+                }
             }
         }
 
-        if (render.hit)
-        {
-            // Fish-eye correction
-            render.correctedDist = render.distance * cosf(render.rayAngle - player.angle);
-            depthBuffer[i] = render.correctedDist;
+        EndBlendMode();
+    }
 
-            render.wallHeight = static_cast<float>(GetScreenHeight() * 50) / render.correctedDist;
+    // ===== STATIC OBJECT RENDER =====
 
-            render.vec.x = i * (static_cast<float>(GetScreenWidth()) / static_cast<float>(RAY_COUNT));
-            render.vec.y = (static_cast<float>(GetScreenHeight()) / 2) - (render.wallHeight / 2);
+    RayCasting::projectSprites(view, player, sprites, proj);
 
-            // ===== Shading Distance =====
+    renderObj.columnWidth = view.columnWidth;
 
-            texMap.shade = 1.0f - (render.correctedDist / MAX_DISTANCE);
-            texMap.shade = Clamp(texMap.shade, 0.2f, 1.0f);
+    for (int index : proj.order)
+    {
+        const SpriteTexture &sprite = spriteTex[sprites.textureId[index]];
 
-            texMap.wallColor = (Color)
-            {
-                .r = (unsigned char)(255 * texMap.shade),
-                .g = (unsigned char)(255 * texMap.shade),
-                .b = (unsigned char)(255 * texMap.shade),
-                .a = 255
-            };
+        renderObj.correctedDist = proj.transformY[index];
+        renderObj.size = proj.size[index];
+        renderObj.screenX = proj.screenX[index];
+
+        // Sprite light: baked floor light of its tile plus binned dynamic light
+        renderObj.tint = WHITE;
+        if (toggleLighting)
+        {
+            Vector2 position = (Vector2){ sprites.posX[index], sprites.posY[index] };
+            int tileX = std::clamp(static_cast<int>(position.x / TILE_SIZE), 0, world.width - 1);
+            int tileY = std::clamp(static_cast<int>(position.y / TILE_SIZE), 0, world.height - 1);
 
-            // ==== Texture Mapping =====
+            float light = fminf(world.floorLight[tileY][tileX] / 255.0f + World::dynamicLight(world, position, (Vector2){ 0.0f, 0.0f }), 1.0f);
+            renderObj.tint = (Color){ (unsigned char)(255 * light), (unsigned char)(255 * light), (unsigned char)(255 * light), 255 };
+        }
 
-            Texture tex = wallTex[map.hitTile - 1];
+        renderObj.spriteLeft  = renderObj.screenX - renderObj.size / 2;
+        renderObj.spriteRight = renderObj.screenX + renderObj.size / 2;
 
-            texMap.hitX = texMap.hitVertical ? fmodf(render.rayPos.y, TILE_SIZE) / TILE_SIZE : fmodf(render.rayPos.x, TILE_SIZE) / TILE_SIZE;
-            
-            texMap.hitX = Clamp(texMap.hitX, 0.0f, 1.0f);
-            texMap.texX = static_cast<int>(texMap.hitX * tex.width);
+        // Ray column covered by this sprite
+        int firstRay = std::max(0, static_cast<int>(floorf(renderObj.spriteLeft / renderObj.columnWidth)));
+        int lastRay = std::min(view.columnCount - 1, static_cast<int>(floorf(renderObj.spriteRight / renderObj.columnWidth)));
 
-            // Flip texture
-            if (!texMap.hitVertical && render.rayDir.y < 0) texMap.texX = tex.width - texMap.texX - 1;
-            if (texMap.hitVertical && render.rayDir.x > 0) texMap.texX = tex.width - texMap.texX - 1;
+        // Merge run of visible column into one quad, split only at occlusion edge
+        renderObj.runStart = -1;
 
-            texMap.src = (Rectangle)
+        for (renderObj.rayIndex = firstRay; renderObj.rayIndex <= lastRay + 1; ++renderObj.rayIndex)
+        {
+            bool visible = renderObj.rayIndex <= lastRay && renderObj.correctedDist < depthBuffer[renderObj.rayIndex];
+
+            if (visible && renderObj.runStart < 0) renderObj.runStart = renderObj.rayIndex;
+
+            if (!visible && renderObj.runStart >= 0)
             {
-                .x = static_cast<float>(texMap.texX), 
-                .y = 0,
-                .width = 1,
-                .height = static_cast<float>(tex.height)
-            };
+                RayCasting::drawSpriteRun(view, sprite, renderObj, renderObj.runStart, renderObj.rayIndex - 1);
+                renderObj.runStart = -1;
+            }
+        }
+
+        // Partial wall in front of the sprite paint over it again (sprite and layer both far to near)
+        for (int i = firstRay; i <= lastRay; ++i)
+        {
+            const ColumnHit &column = temporal.columns[i];
+            if (renderObj.correctedDist >= depthBuffer[i]) continue;
 
-            texMap.dst = (Rectangle)
+            for (int k = column.layerCount - 1; k >= 0; --k)
             {
-                .x = render.vec.x,
-                .y = render.vec.y,
-                .width = (static_cast<float>(GetScreenWidth()) / static_cast<float>(RAY_COUNT)) + 1,
-                .height = render.wallHeight
-            };
+                if (column.layers[k].distance < renderObj.correctedDist) RayCasting::drawWallSlice(view, i, column.layers[k], viewport.layerSpan[i][k], wallTex, world);
+            }
+        }
+    }
+}
 
-            DrawTexturePro(
-                tex,
-                texMap.src,
-                texMap.dst,
-                (Vector2) {0.0f, 0.0f},
-                0.0f,
-                toggleShadeDistance ? texMap.wallColor : WHITE
-            );
+template<std::size_t N>
+int RayCasting::composeWall(RenderView view, int column, WallHit wall, Vector2 span, const std::array<SpriteTexture, N> &wallTex, std::bitset<RENDER_HEIGHT> &cover, const WorldState &world)
+{
+    const SpriteTexture &mask = wallTex[tileInfo[wall.tile].texture];
+    const Texture &tex = mask.texture;
+
+    float wallHeight = (view.height * 50) / wall.distance;
+    float wallTop = view.halfHeight - wallHeight / 2;
+    float pixelPerTexel = wallHeight / tex.height;
+
+    int texX = std::min(static_cast<int>(wall.hitX * tex.width), tex.width - 1);
+    if (wall.flip) texX = tex.width - texX - 1;
+
+    // Span clipped to the view (row of coverage mask)
+    int spanTop = std::max(0, static_cast<int>(roundf(span.x)));
+    int spanBottom = std::min(static_cast<int>(view.height), static_cast<int>(roundf(span.y)));
+
+    int newlyCovered = 0;
 
+    // Opaque run of this texel column only, transparent texel leave row open
+    for (int s = mask.columnOffset[texX]; s < mask.columnOffset[texX + 1]; ++s)
+    {
+        int top = std::max(spanTop, static_cast<int>(roundf(wallTop + mask.spans[s].start * pixelPerTexel)));
+        int bottom = std::min(spanBottom, static_cast<int>(roundf(wallTop + mask.spans[s].end * pixelPerTexel)));
+
+        int y = top;
+        while (y < bottom)
+        {
+            while (y < bottom && cover[y]) ++y;
+
+            int runStart = y;
+            while (y < bottom && !cover[y]) cover.set(y++);
+
+            if (y > runStart)
+            {
+                RayCasting::drawWallSlice(view, column, wall, (Vector2){ static_cast<float>(runStart), static_cast<float>(y) }, wallTex, world);
+                newlyCovered += y - runStart;
+            }
         }
     }
 
-    // ===== STATIC OBJECT RENDER =====
+    return newlyCovered;
+}
+
+template<std::size_t N>
+void RayCasting::drawWallSlice(RenderView view, int column, WallHit wall, Vector2 span, const std::array<SpriteTexture, N> &wallTex, const WorldState &world)
+{
+    // Span is the visible (top, bottom) part on view, wall itself stand on the floor line
+    if (span.y <= span.x) return;
 
-    renderObj.dx = staticObj.position.x - player.position.x;
-    renderObj.dy = staticObj.position.y - player.position.y;
+    float wallHeight = (view.height * 50) / wall.distance;
+    float wallTop = view.halfHeight - wallHeight / 2;
 
-    renderObj.angleToObj = atan2f(renderObj.dy, renderObj.dx);
-    renderObj.relativeAngle = renderObj.angleToObj - player.angle;
+    // ===== Shading Distance =====
 
-    while (renderObj.relativeAngle > PI)  renderObj.relativeAngle -= 2 * PI;
-    while (renderObj.relativeAngle < -PI) renderObj.relativeAngle += 2 * PI;
+    float shade = toggleShadeDistance ? Clamp(1.0f - (wall.distance / MAX_DISTANCE), 0.2f, 1.0f) : 1.0f;
 
-    if (fabs(renderObj.relativeAngle) < FOV / 2)
+    // Baked light of hit face plus dynamic light binned to the hit tile
+    if (toggleLighting)
     {
-        renderObj.distance = sqrtf(renderObj.dx * renderObj.dx + renderObj.dy * renderObj.dy);
-        renderObj.correctedDist = renderObj.distance * cosf(renderObj.relativeAngle);
+        const std::array<Vector2, FACE_COUNT> faceNormal = {{ {0.0f, -1.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}, {-1.0f, 0.0f} }};
+        int face = World::faceOf(wall.hitVertical, wall.flip);
 
-        renderObj.size = static_cast<float>((GetScreenHeight() * staticObj.scale) / renderObj.correctedDist);
-        renderObj.screenX = static_cast<float>((renderObj.relativeAngle / (FOV / 2)) * (GetScreenWidth() / 2) + (GetScreenWidth() / 2));
+        // Hit point on the face
+        Vector2 point = wall.hitVertical
+            ? (Vector2){ static_cast<float>((wall.mapX + (face == FACE_EAST)) * TILE_SIZE), (wall.mapY + wall.hitX) * TILE_SIZE }
+            : (Vector2){ (wall.mapX + wall.hitX) * TILE_SIZE, static_cast<float>((wall.mapY + (face == FACE_SOUTH)) * TILE_SIZE) };
 
-        renderObj.spriteLeft  = renderObj.screenX - renderObj.size / 2;
-        renderObj.spriteRight = renderObj.screenX + renderObj.size / 2;
+        float light = world.faceLight[wall.mapY][wall.mapX][face] / 255.0f;
+        if (!world.dynamicLights.empty()) light += World::dynamicLight(world, point, faceNormal[face]);
 
-        renderObj.columnWidth = static_cast<float>(GetScreenWidth()) / RAY_COUNT;
+        shade *= fminf(light, 1.0f);
+    }
 
-        for (float x = renderObj.spriteLeft; x < renderObj.spriteRight; x += renderObj.columnWidth)
-        {
-            renderObj.rayIndex = static_cast<int>(x / renderObj.columnWidth);
-            if (renderObj.rayIndex < 0 || renderObj.rayIndex >= RAY_COUNT) continue;
+    Color wallColor = (Color)
+    {
+        .r = (unsigned char)(255 * shade),
+        .g = (unsigned char)(255 * shade),
+        .b = (unsigned char)(255 * shade),
+        .a = 255
+    };
 
-            if (renderObj.correctedDist < depthBuffer[renderObj.rayIndex])
-            {
-                renderObj.texX = (x - renderObj.spriteLeft) / renderObj.size;
-                renderObj.texX = Clamp(renderObj.texX, 0.0f, 1.0f);
+    // ==== Texture Mapping =====
 
-                Rectangle src = (Rectangle) 
-                {
-                    .x = renderObj.texX * staticObj.texture.width,
-                    .y = 0.0f,
-                    .width = staticObj.texture.width / renderObj.size,
-                    .height = static_cast<float>(staticObj.texture.height)
-                };
+    const Texture &tex = wallTex[tileInfo[wall.tile].texture].texture;
 
-                Rectangle dst = (Rectangle) 
-                {
-                    .x = x,
-                    .y = (GetScreenHeight() / 2) - renderObj.size / 2,
-                    .width = renderObj.columnWidth + 1,
-                    .height = renderObj.size
-                };
-
-                DrawTexturePro(
-                    staticObj.texture,
-                    src,
-                    dst,
-                    {0, 0},
-                    0.0f,
-                    WHITE
-                );
+    int texX = std::min(static_cast<int>(wall.hitX * tex.width), tex.width - 1);
 
-            }
-        }
+    // Flip texture
+    if (wall.flip) texX = tex.width - texX - 1;
+
+    // Same texel scale with full wall, so partial wall show lower part of texture
+    float texelPerPixel = tex.height / wallHeight;
+
+    Rectangle src = (Rectangle)
+    {
+        .x = static_cast<float>(texX),
+        .y = (span.x - wallTop) * texelPerPixel,
+        .width = 1,
+        .height = (span.y - span.x) * texelPerPixel
+    };
+
+    Rectangle dst = (Rectangle)
+    {
+        .x = view.x + column * view.columnWidth,
+        .y = view.y + span.x,
+        .width = view.columnWidth + 1,
+        .height = span.y - span.x
+    };
+
+    DrawTexturePro(
+        tex,
+        src,
+        dst,
+        (Vector2) {0.0f, 0.0f},
+        0.0f,
+        wallColor
+    );
+}
+
+void RayCasting::drawSpriteRun(RenderView view, const SpriteTexture &sprite, RenderStaticObj renderObj, int firstRay, int lastRay)
+{
+    const Texture &texture = sprite.texture;
+
+    // Screen span of the run, clipped to sprite edge
+    float x0 = fmaxf(renderObj.spriteLeft, firstRay * renderObj.columnWidth);
+    float x1 = fminf(renderObj.spriteRight, (lastRay + 1) * renderObj.columnWidth);
+    if (x1 <= x0) return;
+
+    // Matching texel range (UV)
+    float u0 = (x0 - renderObj.spriteLeft) / renderObj.size * texture.width;
+    float u1 = (x1 - renderObj.spriteLeft) / renderObj.size * texture.width;
+
+    int firstColumn = std::clamp(static_cast<int>(u0), 0, texture.width - 1);
+    int lastColumn = std::clamp(static_cast<int>(ceilf(u1)) - 1, firstColumn, texture.width - 1);
+
+    // Trim fully transparent texel column at both edge of the run
+    while (firstColumn <= lastColumn && sprite.columnOffset[firstColumn] == sprite.columnOffset[firstColumn + 1]) ++firstColumn;
+    while (lastColumn >= firstColumn && sprite.columnOffset[lastColumn] == sprite.columnOffset[lastColumn + 1]) --lastColumn;
+    if (lastColumn < firstColumn) return;
+
+    u0 = fmaxf(u0, static_cast<float>(firstColumn));
+    u1 = fminf(u1, static_cast<float>(lastColumn + 1));
+    x0 = renderObj.spriteLeft + u0 / texture.width * renderObj.size;
+    x1 = renderObj.spriteLeft + u1 / texture.width * renderObj.size;
+
+    // Union of opaque extent over all texel column in the run
+    int top = texture.height;
+    int bottom = 0;
+    for (int column = firstColumn; column <= lastColumn; ++column)
+    {
+        int first = sprite.columnOffset[column];
+        int last = sprite.columnOffset[column + 1];
+        if (first == last) continue;
+
+        top = std::min(top, static_cast<int>(sprite.spans[first].start));
+        bottom = std::max(bottom, static_cast<int>(sprite.spans[last - 1].end));
     }
-}
\ No newline at end of file
+
+    if (bottom <= top) return;
+
+    float texelHeight = renderObj.size / texture.height;
+
+    Rectangle src = (Rectangle) 
+    {
+        .x = u0,
+        .y = static_cast<float>(top),
+        .width = u1 - u0,
+        .height = static_cast<float>(bottom - top)
+    };
+
+    Rectangle dst = (Rectangle) 
+    {
+        .x = view.x + x0,
+        .y = view.y + view.halfHeight - renderObj.size / 2 + top * texelHeight,
+        .width = x1 - x0,
+        .height = (bottom - top) * texelHeight
+    };
+
+    DrawTexturePro(
+        texture,
+        src,
+        dst,
+        {0, 0},
+        0.0f,
+        renderObj.tint
+    );
+}
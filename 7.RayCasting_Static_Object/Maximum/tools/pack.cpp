@@ -0,0 +1,109 @@
+// Asset pack builder: pack every file under assets/ into one mmap friendly file
+// Usage: pack <project dir> <output file>
+
+#include "../src/include/Pack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+typedef struct SourceFile
+{
+    std::string name;
+    std::filesystem::path path;
+    unsigned long long size;
+} SourceFile;
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "[Pack] Usage: pack <project dir> <output file>" << std::endl;
+        return 1;
+    }
+
+    const std::filesystem::path root = argv[1];
+    const std::filesystem::path output = std::filesystem::absolute(argv[2]);
+
+    // ==== Collect Source File ====
+
+    std::vector<SourceFile> files;
+
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(root / "assets"))
+    {
+        if (!entry.is_regular_file()) continue;
+
+        // Never pack old pack or the output itself
+        if (entry.path().extension() == ".pack" || std::filesystem::absolute(entry.path()) == output) continue;
+
+        // Logical name same with File::resolve
+        std::string name = entry.path().lexically_relative(root).generic_string();
+        if (name.size() >= PACK_NAME_MAX)
+        {
+            std::cerr << "[Pack] Error: Name too long " << name << std::endl;
+            return 1;
+        }
+
+        files.push_back((SourceFile){ name, entry.path(), static_cast<unsigned long long>(entry.file_size()) });
+    }
+
+    // Sorted index, runtime lookup with binary search
+    std::sort(files.begin(), files.end(), [](const SourceFile &a, const SourceFile &b) { return a.name < b.name; });
+
+    // ==== Layout: Header, Index, Aligned Blob ====
+
+    PackHeader header = {};
+    std::memcpy(header.magic, PACK_MAGIC, 4);
+    header.version = PACK_VERSION;
+    header.count = static_cast<unsigned int>(files.size());
+    header.alignment = PACK_ALIGNMENT;
+    header.indexOffset = sizeof(PackHeader);
+
+    auto align = [](unsigned long long offset) { return (offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT; };
+
+    std::vector<PackEntry> entries(files.size());
+    unsigned long long offset = align(header.indexOffset + entries.size() * sizeof(PackEntry));
+
+    for (std::size_t i = 0; i < files.size(); ++i)
+    {
+        std::strncpy(entries[i].name, files[i].name.c_str(), PACK_NAME_MAX - 1);
+        entries[i].offset = offset;
+        entries[i].size = files[i].size;
+        offset = align(offset + files[i].size);
+    }
+
+    // ==== Write ====
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[Pack] Error: Can not write " << output << std::endl;
+        return 1;
+    }
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(PackEntry)));
+
+    std::vector<char> buffer;
+    for (std::size_t i = 0; i < files.size(); ++i)
+    {
+        // Zero padding up to aligned blob start
+        buffer.assign(entries[i].offset - static_cast<unsigned long long>(out.tellp()), 0);
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+        std::ifstream in(files[i].path, std::ios::binary);
+        buffer.resize(files[i].size);
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+        std::cout << "[Pack] " << files[i].name << " (" << files[i].size << " byte)" << std::endl;
+    }
+
+    std::cout << "[Pack] Complete " << files.size() << " file to " << output.string() << std::endl;
+
+    return 0;
+}